@@ -0,0 +1,70 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * Each byte written in the EEPROM takes 3.3 ms on the ATmega 328p: a row of
+ * 3 FLOAT stops the sketch during ~40 ms. With ASYNC, the bytes go to a queue
+ * (TDB_WRITE_QUEUE bytes) and INSERT returns at once. poll() in loop() writes
+ * them one by one when the EEPROM is ready. The rows can be read at once,
+ * even if their bytes are still in the queue.
+ *
+ * With #define TDB_EE_READY_ISR before the include, the queue is written by
+ * the EEPROM ready interrupt (AVR) and poll() is not needed.
+ *
+ * LG: | tp  | hm  | ps  |
+ *     -------------------
+ *     | 25.3| 61.0| 1013|
+ *     | ... | ... | ... |
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+TableData     logs;
+
+unsigned long lastLog = 0;
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+  delay(1000);
+
+  Column c_logs[3] = {{"tp", "FLOAT"}, {"hm", "FLOAT"}, {"ps", "FLOAT"}};
+  mem.CREATE_TABLE("LG", 20, 3, c_logs);
+  logs = mem.OPEN("LG");
+
+  // 1- writes go to the queue from now
+  mem.ASYNC();
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  // 2- one byte per call if the EEPROM is ready, never waits
+  mem.poll();
+
+  if (millis() - lastLog >= 1000) {
+    lastLog = millis();
+
+    float tp = analogRead(A0) * 0.48828125;
+    float hm = analogRead(A1) * 0.09765625;
+    float ps = 1013;
+    unsigned long start = micros();
+    logs.INSERT("tp", &tp).INSERT("hm", &hm).INSERT("ps", &ps).DONE();
+    PRINT("INSERT (us)", micros() - start);
+
+    // 3- the last row is already visible
+    float last = 0;
+    logs.WHERE("tp", isEqualTo, &tp).SELECT("hm", &last).DONE();
+    PRINT("last hm", last);
+  }
+}
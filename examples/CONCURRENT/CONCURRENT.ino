@@ -0,0 +1,92 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * Two tasks of FreeRTOS (ESP32) work on the same table "LG": a task logs the
+ * temperature and the humidity each second, another one reads the rows to
+ * send them (a web server,...).
+ *
+ * With TDB_CONCURRENT, the task which writes takes a lock until DONE: a second
+ * writer waits for it. The task which reads never waits: if a row was written
+ * during its reads, its data may mix two rows and DONE returns false, the
+ * statement is run again. A writer checks DONE too and runs its statement
+ * again when it is false.
+ *
+ * LG: | tp  | hm  |
+ *     -------------
+ *     | 25.3| 61.0|
+ *     | ... | ... |
+ */
+
+#define TDB_CONCURRENT 1
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+const uint8_t NB_ROWS = 60;
+
+void logTask(void* arg) {
+  for (;;) {
+    float tp = analogRead(A0) * 0.0805;
+    float hm = analogRead(A1) * 0.0244;
+
+    // 1- TO / FROM: each task has its own statement. A write is refused when
+    // the statement read the table (WHERE,...) before another task wrote it:
+    // DONE returns false and the statement is run again
+    bool done = false;
+    while (!done) {
+      done = mem.TO("LG").INSERT("tp", &tp).INSERT("hm", &hm).DONE();
+    }
+    vTaskDelay(pdMS_TO_TICKS(1000));
+  }
+}
+
+void sendTask(void* arg) {
+  float tp[NB_ROWS];
+  float hm[NB_ROWS];
+  int   nbValue = 0;
+
+  for (;;) {
+    // 2- false: a row was written during the reads, read again
+    bool done = false;
+    while (!done) {
+      done = mem.FROM("LG")
+                 .SELECT_ALL("tp", tp, nbValue)
+                 .SELECT_ALL("hm", hm, nbValue)
+                 .DONE();
+    }
+
+    for (int i = 0; i < nbValue; i++) {
+      PRINT("tp", tp[i]);
+      PRINT("hm", hm[i]);
+    }
+    vTaskDelay(pdMS_TO_TICKS(5000));
+  }
+}
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(115200);
+  delay(1000);
+
+  Column cols[2] = {{"tp", "FLOAT"}, {"hm", "FLOAT"}};
+  PRINT("status", mem.CREATE_TABLE("LG", NB_ROWS, 2, cols));
+
+  xTaskCreate(logTask, "log", 4096, nullptr, 2, nullptr);
+  xTaskCreate(sendTask, "send", 4096, nullptr, 1, nullptr);
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  vTaskDelay(pdMS_TO_TICKS(1000));
+}
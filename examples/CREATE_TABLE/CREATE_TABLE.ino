@@ -22,6 +22,8 @@
  *
  * int    -> "INT"
  * float  -> "FLOAT"
+ * float in 2 bytes -> "FLOAT16" or "FIXED16(10)" (0.1 precision)
+ * a few distinct texts ("OK", "WARN",...) of 8 chars -> "DICT8"
  *
  * and more - get them at
  * table name and columns are not more than 2 char
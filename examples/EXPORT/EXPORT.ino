@@ -0,0 +1,56 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * In INSERT example,
+ * We have inserted 3 data in the table of name EM
+ * | ag | rt  |
+ * ------------
+ * | 25 | 8.3 |
+ * | 30 | 7.9 |
+ * | 21 | 8.63|
+ * ------------
+ *
+ * Now we want to get the data on the computer. Instead of SELECT and PRINT each
+ * value, we send a binary image of the data base on the Serial. Save the bytes
+ * received in a file and convert it to CSV with the tool in extras/tools:
+ *
+ *   tdb_decode image.bin
+ *
+ * The same image can be sent back to a board and loaded with IMPORT.
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(115200);
+  delay(1000);
+
+  // 1- the whole data base: all tables with their columns and data
+  int nbRows = mem.EXPORT(Serial);
+
+  // 2- or only the data of a table which match a FILTER
+  int min_age = 22;
+  mem.FROM("EM").WHERE("ag", FILTER::isGreaterThan, &min_age).EXPORT(Serial).DONE();
+
+  // 3- to load an image sent by the computer on the Serial
+  // int status = mem.IMPORT(Serial);
+  // if (status != STATUS_IMPORTED) { ... }
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+}
@@ -0,0 +1,65 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * Readings of sensors are stored in a table "RD" and the calibration of each
+ * sensor in a table "CL". Both have the id of the sensor:
+ *
+ * RD: | id | vl  |      CL: | id | of  |
+ *     ------------          ------------
+ *     | 1  | 20.5|          | 1  | -0.5|
+ *     | 2  | 19.8|          | 2  | 0.25|
+ *     | 1  | 20.9|          ------------
+ *     ------------
+ *
+ * JOIN calls a function for each reading with the calibration of its sensor.
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+// 1- called for each pair: reading (left) and calibration (right)
+void calibrate(TableData& readings, uint8_t nthReading, TableData& calibrations,
+               uint8_t nthCalibration) {
+  byte  id;
+  float value;
+  float offset;
+
+  readings.SELECT("id", &id, nthReading).SELECT("vl", &value, nthReading);
+  calibrations.SELECT("of", &offset, nthCalibration);
+
+  PRINT("sensor", id);
+  PRINT("calibrated", value + offset);
+}
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+  delay(1000);
+
+  Column c_rd[2] = {{"id", "BYTE"}, {"vl", "FLOAT"}};
+  Column c_cl[2] = {{"id", "BYTE"}, {"of", "FLOAT"}};
+  mem.CREATE_TABLE("RD", 10, 2, c_rd);
+  mem.CREATE_TABLE("CL", 2, 2, c_cl);
+
+  // 2- the right table must be a TableData of its own
+  TableData calibrations = mem.OPEN("CL");
+
+  // 3- join on the id of the sensor
+  mem.FROM("RD").JOIN(calibrations, "id", "id", calibrate).DONE();
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+}
@@ -0,0 +1,65 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * TO and FROM share the same TableData: each call search the table again.
+ * With OPEN, each table has its own TableData that we keep for the lifetime
+ * of the sketch. Here a table "CF" holds the period of the measures and a
+ * table "LG" logs the temperatures:
+ *
+ * CF: | pr |     LG: | tp  |
+ *     ------         -------
+ *     | 10 |         | 25.3|
+ *                    | ... |
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+// 1- our tables, opened once
+TableData conf;
+TableData logs;
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+  delay(1000);
+
+  // 2- create the tables the first time
+  Column c_conf[1] = {{"pr", "BYTE"}};
+  Column c_logs[1] = {{"tp", "FLOAT"}};
+  mem.CREATE_TABLE("CF", 1, 1, c_conf);
+  mem.CREATE_TABLE("LG", 60, 1, c_logs);
+
+  // 3- open them
+  conf = mem.OPEN("CF");
+  logs = mem.OPEN("LG");
+
+  if (conf.COUNT() == 0) {
+    byte period = 10;
+    conf.INSERT("pr", &period).DONE();
+  }
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  byte period = 0;
+  conf.SELECT("pr", &period).DONE();
+
+  float temperature = analogRead(A0) * 0.48828125;
+  logs.INSERT("tp", &temperature).DONE();
+
+  PRINT("nb logs", logs.COUNT());
+  delay(period * 1000UL);
+}
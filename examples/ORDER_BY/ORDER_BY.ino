@@ -0,0 +1,56 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * In INSERT example,
+ * We have inserted 3 data in the table of name EM
+ * | ag | rt  |
+ * ------------
+ * | 25 | 8.3 |
+ * | 30 | 7.9 |
+ * | 21 | 8.63|
+ * ------------
+ *
+ * Now we get them sorted by age, and only the 2 highest rates.
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+  delay(1000);
+
+  int   age[3];
+  float rate[3];
+  int   nbValue = 0;
+
+  // 1- all data from the youngest to the oldest
+  mem.FROM("EM").ORDER_BY("ag", ASC).SELECT_ALL("ag", age, nbValue).DONE();
+  for (size_t i = 0; i < nbValue; i++) {
+    PRINT("age", age[i]);
+  }
+
+  // 2- the 2 highest rates: the table is read once and only 2 data are kept
+  mem.FROM("EM").TOP_K("rt", 2, DESC).SELECT_ALL("rt", rate, nbValue).SELECT_ALL("ag", age, nbValue).DONE();
+  for (size_t i = 0; i < nbValue; i++) {
+    PRINT("rate", rate[i]);
+    PRINT("age", age[i]);
+  }
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+}
@@ -0,0 +1,75 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * A table "TP" logs the temperature each minute. The data are sent to a
+ * gateway by pages of 8 data: only 8 data are in SRAM at once and only the
+ * rows of a page are read from the EEPROM, the first page or the last one.
+ *
+ * | tm  | tp   |
+ * --------------
+ * | 60  | 20.5 |
+ * | 120 | 20.7 |
+ * | ... | ...  |
+ * --------------
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+const uint8_t PAGE_SIZE = 8;
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+  delay(1000);
+
+  Column cols[2] = {{"tm", "ULONG"}, {"tp", "FLOAT"}};
+  int    status  = mem.CREATE_TABLE("TP", 50, 2, cols);
+  PRINT("status", status);
+
+  for (unsigned long tm = 60; tm <= 30 * 60; tm += 60) {
+    float tp = 20.5 + (tm % 600) / 300.0;
+    mem.TO("TP").INSERT("tm", &tm).INSERT("tp", &tp).DONE();
+  }
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  unsigned long times[PAGE_SIZE];
+  float         temps[PAGE_SIZE];
+  int           nbValue = 0;
+
+  // 1- the 8 data after the 16 first ones
+  mem.FROM("TP").OFFSET(16).LIMIT(PAGE_SIZE).SELECT_ALL("tm", times, nbValue).DONE();
+  PRINT("third page", nbValue);
+
+  // 2- all data, page after page: the token tells where the next page starts
+  // and is -1 after the last one
+  int token = 0;
+  while (token >= 0) {
+    mem.FROM("TP")
+        .PAGE(PAGE_SIZE, token)
+        .SELECT_ALL("tm", times, nbValue)
+        .SELECT_ALL("tp", temps, nbValue)
+        .DONE();
+
+    for (int i = 0; i < nbValue; i++) {
+      PRINT("tm", times[i]);
+      PRINT("tp", temps[i]);
+    }
+  }
+
+  delay(60000);
+}
@@ -0,0 +1,68 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * In INSERT example,
+ * We have inserted 3 data in the table of name EM
+ * | ag | rt  |
+ * ------------
+ * | 25 | 8.3 |
+ * | 30 | 7.9 |
+ * | 21 | 8.63|
+ * ------------
+ *
+ * In WHERE example we filter data each time with FROM / WHERE / SELECT_ALL.
+ * When the same query runs again and again (in loop), we prepare it once:
+ * the table, its columns and the FILTER are found once and each run only
+ * reads the data.
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+// 1- the value used by the FILTER: change it before each run
+int max_age = 28;
+
+// 2- prepare the query: ages less than max_age in the table EM
+PreparedQuery<int> young(mem, "EM", "ag", FILTER::isLessThan, &max_age);
+
+// 3- position of the columns to select
+int col_age  = young.COLUMN("ag");
+int col_rate = young.COLUMN("rt");
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+  delay(1000);
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  int   age[6];
+  float rate[6];
+  int   nbValue = 0;
+
+  // 4- run the query and get data. With TDB_CONCURRENT, DONE is false if
+  // another task wrote meanwhile: run it again
+  young.EXECUTE().SELECT_ALL(col_age, age, nbValue).SELECT_ALL(col_rate, rate, nbValue).DONE();
+
+  for (size_t i = 0; i < nbValue; i++) {
+    PRINT("age", age[i]);
+    PRINT("rate", rate[i]);
+  }
+
+  // 5- next time with another value
+  max_age = (max_age == 28) ? 31 : 28;
+  delay(5000);
+}
@@ -0,0 +1,74 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * A table "DV" keeps the state of each device. Its column "id" is declared
+ * as primary key ("PK" after the type): there is one row per id and the rows
+ * are found by their id without reading the whole table.
+ *
+ * | id | st |
+ * -----------
+ * | 3  | 1  |
+ * | 7  | 0  |
+ * -----------
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+  delay(1000);
+
+  // 1- the primary key is given after the type of the column
+  Column devices[2] = {{"id", "BYTE PK"}, {"st", "BYTE"}};
+  int    status     = mem.CREATE_TABLE("DV", 20, 2, devices);
+  PRINT("status", status);
+
+  // 2- insert the device or update it if it already exists
+  byte id    = 3;
+  byte state = 1;
+  mem.TO("DV").UPSERT(&id).INSERT("st", &state).DONE();
+
+  id    = 7;
+  state = 0;
+  mem.TO("DV").UPSERT(&id).INSERT("st", &state).DONE();
+
+  // again the device 3: its row is updated
+  id    = 3;
+  state = 2;
+  mem.TO("DV").UPSERT(&id).INSERT("st", &state).DONE();
+
+  // INSERT doesn't add a second row for an id: DONE returns false
+  PRINT("inserted", mem.TO("DV").INSERT("id", &id).INSERT("st", &state).DONE());  // 0
+
+  PRINT("devices", mem.FROM("DV").COUNT());  // 2
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  byte id    = 3;
+  byte state = 0;
+
+  // 3- get a device by its id: COUNT is 0 if it doesn't exist
+  TableData& device = mem.FROM("DV").GET(&id);
+  if (device.COUNT() == 1) {
+    device.SELECT("st", &state);
+    PRINT("state", state);
+  }
+  device.DONE();
+
+  delay(5000);
+}
@@ -0,0 +1,66 @@
+/**
+ * @author Tawaliou ALAO Engineer at YoupiLab (sales@youpilab.com)
+ * @remark Thanks to my brother ALIDOU Abdoul Majeed to help to define the database architecture
+ * @remark Thanks to YoupiLab: https://youpilab.com/ to support the project
+ * @brief  A tiny database to manipulate EEPROM easily
+ * @version 1.0.0
+ * @date 2021-09-15
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+/**
+ * A table "TM" keeps the temperature of the last 30 minutes, one row per
+ * minute. When it is full, the oldest rows are overwritten: before, each 10
+ * rows are folded into one row of the table "TT" (their average), so "TT"
+ * keeps the last 10 hours by 10 minutes. And each 6 rows of "TT" into one row
+ * of "TH" (the highest), the last 36 hours by hour.
+ *
+ *       TM (30)              TT (60)              TH (36)
+ * | tm  | tp   |       | tm  | tp   |       | tm   | tp   |
+ * --------------  -->  --------------  -->  ---------------
+ * | 60  | 20.5 |  10   | 330 | 20.6 |   6   | 3300 | 21.2 |
+ * | ... | ...  |       | ... | ...  |       | ...  | ...  |
+ * --------------       --------------       ---------------
+ */
+
+#include <TinyDatabase_Arduino.h>
+
+// MemoryManager object to access data base
+MemoryManager mem;
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+  delay(1000);
+
+  // 1- the tables which fold their oldest rows are created with TABLE_ROLLUP.
+  // The rollup tables can keep their data in fewer bytes (FLOAT16)
+  Column minutes[2] = {{"tm", "ULONG"}, {"tp", "FLOAT"}};
+  Column history[2] = {{"tm", "ULONG"}, {"tp", "FLOAT16"}};
+  PRINT("status", mem.CREATE_TABLE("TM", 30, 2, minutes, TABLE_ROLLUP));
+  PRINT("status", mem.CREATE_TABLE("TT", 60, 2, history, TABLE_ROLLUP));
+  PRINT("status", mem.CREATE_TABLE("TH", 36, 2, history));
+
+  // 2- where the rows go: kept in the memory, only once is enough
+  PRINT("rollup", mem.ROLLUP("TM", "TT", averageOf, 10));
+  PRINT("rollup", mem.ROLLUP("TT", "TH", maxOf, 6));
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  unsigned long tm = millis() / 1000;
+  float         tp = analogRead(A0) * 0.1;
+
+  // 3- only the table of the minutes is written: the others are filled when
+  // its rows are overwritten
+  mem.TO("TM").INSERT("tm", &tm).INSERT("tp", &tp).DONE();
+
+  // the average of the last 10 hours
+  float avg = 0;
+  mem.FROM("TT").AGGREGATE("tp", averageOf, &avg).DONE();
+  PRINT("average", avg);
+
+  delay(60000);
+}
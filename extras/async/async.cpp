@@ -0,0 +1,160 @@
+/**
+ * @brief Random test of the queue of MemoryManager::ASYNC: random writes,
+ * updates, reads and reads by blocks, on the internal EEPROM and on a second
+ * device, with poll and time going on between them. The same writes go to a
+ * shadow array written at once. It checks that:
+ *  - each read gives the last value written (read your writes)
+ *  - an address of the memory differs from the shadow only if its write is
+ *    still in the queue: no more of them than bytes waiting
+ *  - after SYNC, the memories are the shadow arrays
+ *  - with -DTDB_EE_READY_ISR, the bytes of the internal EEPROM are written by
+ *    the EEPROM ready interrupt (its model in extras/host): it never runs
+ *    during an access of the library to the memory
+ *
+ * Build and run from the root of the library:
+ *
+ *   g++ -std=gnu++11 -fpermissive -Wno-write-strings -O2 -DE2END=0xFFF \
+ *       -Iextras/host -Isrc extras/async/async.cpp -o tdb_async
+ *   ./tdb_async [seeds] [operations]
+ *
+ */
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+// few addresses so the queue often has many writes of the same one
+const int WINDOW = 48;
+const int FROM1  = 100;            // first address of the internal EEPROM
+const int FROM2  = DEVICE2 + 200;  // first address of the second device
+
+/********************************************************************************************************************************/
+static EEPROMClass external;
+
+struct HostDevice : public StorageDevice {
+  uint8_t read(int idx) { return external.read(idx); }
+  void    write(int idx, uint8_t val) { external.write(idx, val); }
+  bool    ready() { return external.ready(); }
+  int     length() { return external.length(); }
+  void    readBlock(int idx, uint8_t* buf, uint8_t len) { external.readBlock(idx, buf, len); }
+};
+
+static HostDevice    device;
+static MemoryManager mem;
+
+static uint8_t shadow[2][WINDOW];
+static long    failures = 0;
+
+static void fail(const char* what, unsigned seed, long op, int addr, int got, int expected) {
+  if (failures++ < 10) {
+    printf("FAIL seed %u op %ld: %s at %d: %d instead of %d\n", seed, op, what, addr, got, expected);
+  }
+}
+
+static int addressOf(int dev, int i) { return (dev == 0 ? FROM1 : FROM2) + i; }
+
+// the byte in the memory, without going through the queue
+static uint8_t& cellOf(int dev, int i) {
+  return dev == 0 ? EEPROM.data()[FROM1 + i] : external.data()[FROM2 - DEVICE2 + i];
+}
+
+/********************************************************************************************************************************/
+static void run(unsigned seed, long nbOps) {
+  srand(seed);
+
+  // the same content everywhere before the asynchronous writes
+  for (int dev = 0; dev < 2; dev++) {
+    for (int i = 0; i < WINDOW; i++) {
+      shadow[dev][i] = rand() & 0xFF;
+      cellOf(dev, i) = shadow[dev][i];
+    }
+  }
+  // a slower second device: the bytes of the internal EEPROM pass before its own
+  external.setProfile(seed % 2 == 0 ? PROFILE_AVR_INTERNAL : PROFILE_I2C_24LC256);
+  mem.ASYNC(true);
+
+  for (long op = 0; op < nbOps; op++) {
+    int dev  = rand() % 2;
+    int i    = rand() % WINDOW;
+    int addr = addressOf(dev, i);
+
+    switch (rand() % 8) {
+      case 0:
+      case 1: {  // write
+        uint8_t v = rand() & 0xFF;
+        STORAGE.write(addr, v);
+        shadow[dev][i] = v;
+        break;
+      }
+      case 2: {  // update: often the same value, nothing written
+        uint8_t v = (rand() % 2) ? shadow[dev][i] : rand() & 0xFF;
+        STORAGE.update(addr, v);
+        shadow[dev][i] = v;
+        break;
+      }
+      case 3: {  // put of a word
+        if (i + 2 > WINDOW) break;
+        uint16_t v = rand() & 0xFFFF;
+        STORAGE.put(addr, v);
+        memcpy(&shadow[dev][i], &v, sizeof(v));
+        break;
+      }
+      case 4: {  // read
+        int got = STORAGE.read(addr);
+        if (got != shadow[dev][i]) fail("read", seed, op, addr, got, shadow[dev][i]);
+        break;
+      }
+      case 5: {  // read by block
+        uint8_t len = 1 + rand() % (WINDOW - i);
+        uint8_t buf[WINDOW];
+        STORAGE.readBlock(addr, buf, len);
+        for (uint8_t k = 0; k < len; k++) {
+          if (buf[k] != shadow[dev][i + k]) fail("readBlock", seed, op, addr + k, buf[k], shadow[dev][i + k]);
+        }
+        break;
+      }
+      case 6:  // the sketch does something else
+        EEPROM.idle(rand() % 4000000);
+        break;
+      default:
+        mem.poll();
+        break;
+    }
+
+    // a byte not yet written is in the queue
+    int behind = 0;
+    for (int d = 0; d < 2; d++) {
+      for (int k = 0; k < WINDOW; k++) behind += cellOf(d, k) != shadow[d][k];
+    }
+    if (behind > STORAGE.pending()) fail("bytes behind the queue", seed, op, behind, behind, STORAGE.pending());
+  }
+
+  mem.SYNC();
+  mem.ASYNC(false);
+  for (int dev = 0; dev < 2; dev++) {
+    for (int i = 0; i < WINDOW; i++) {
+      int got = cellOf(dev, i);
+      if (got != shadow[dev][i]) fail("image after SYNC", seed, nbOps, addressOf(dev, i), got, shadow[dev][i]);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned nbSeeds = argc > 1 ? atoi(argv[1]) : 50;
+  long     nbOps   = argc > 2 ? atol(argv[2]) : 20000;
+
+  Serial.mute();
+  external.setSize(DEVICE2);
+  mem.DEVICE(device);
+
+  for (unsigned seed = 1; seed <= nbSeeds; seed++) run(seed, nbOps);
+
+  // an interrupt during a read takes its address register (EEAR)
+  unsigned long interrupted = EEPROM.stats().interrupted;
+  if (interrupted != 0) fail("accesses interrupted", nbSeeds, nbOps, 0, interrupted, 0);
+
+  printf("%u seeds, %ld operations each: %s\n", nbSeeds, nbOps, failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
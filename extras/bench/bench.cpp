@@ -0,0 +1,656 @@
+/**
+ * @brief Host benchmark of the TableData operations against the simulated
+ * EEPROM (extras/host). For each operation we sweep the table capacity, the
+ * number of columns and the width of the columns and we report:
+ *  - cpu_us: CPU time of the operation on the host
+ *  - reads: bytes read from the EEPROM
+ *  - writes: physical writes (program cycles)
+ *  - device_us: modeled time spent by the MCU on the EEPROM
+ *
+ * Build and run from the root of the library:
+ *
+ *   g++ -std=gnu++11 -fpermissive -Wno-write-strings -O2 -DE2END=0xFFF \
+ *       -Iextras/host -Isrc extras/bench/bench.cpp -o tdb_bench
+ *   ./tdb_bench --baseline extras/bench/baseline.txt
+ *
+ * The STRIPED_* operations use a second device of the same kind
+ * (MemoryManager::DEVICE): reads and writes are those of both devices.
+ *
+ * Options:
+ *   --baseline FILE        compare with FILE and exit with 1 on regression
+ *   --write-baseline FILE  store the results in FILE
+ *   --tolerance PCT        allowed increase of reads/writes/device_us (default 2)
+ *   --cpu-tolerance PCT    allowed increase of cpu_us (default 100), -1 to ignore
+ *   --profile avr|i2c      memory modeled: internal EEPROM of the ATmega (default)
+ *                          or a 24LC256 on I2C. The baseline is for avr
+ *
+ */
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+/********************************************************************************************************************************/
+struct Metrics {
+  double cpuUs;
+  double reads;
+  double writes;
+  double deviceUs;
+};
+
+struct Config {
+  uint8_t     capacity;
+  uint8_t     nbCols;
+  const char* type;  // type of each column
+};
+
+static std::vector<std::pair<std::string, Metrics> > results;
+
+/********************************************************************************************************************************/
+// second device of the TABLE_STRIPED tables
+static EEPROMClass external;
+
+struct HostDevice : public StorageDevice {
+  uint8_t read(int idx) { return external.read(idx); }
+  void    write(int idx, uint8_t val) { external.write(idx, val); }
+  bool    ready() { return external.ready(); }
+  int     length() { return external.length(); }
+  void    readBlock(int idx, uint8_t* buf, uint8_t len) { external.readBlock(idx, buf, len); }
+};
+
+static HostDevice device;
+
+/********************************************************************************************************************************/
+/**
+ * @brief Measure a function. The metrics are divided by the number of
+ * operations done by the function. The function is run a few times after its
+ * setup, we keep the smallest CPU time (the EEPROM metrics are the same each
+ * time).
+ */
+const int NB_RUNS = 5;
+
+template <typename S, typename F>
+static Metrics measure(S setup, F fn, int nbOps = 1) {
+  Metrics m;
+  m.cpuUs = -1;
+  for (int run = 0; run < NB_RUNS; run++) {
+    setup();
+
+    EEPROM.resetStats();
+    external.resetStats();
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+
+    double cpuUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / nbOps;
+    if (m.cpuUs < 0 || cpuUs < m.cpuUs) m.cpuUs = cpuUs;
+  }
+
+  // the devices work at the same time: the MCU waits for the last one
+  EEPROMStats s = EEPROM.stats();
+  EEPROMStats x = external.stats();
+  m.reads       = double(s.reads + x.reads) / nbOps;
+  m.writes      = double(s.writes + x.writes) / nbOps;
+  m.deviceUs    = double(s.modeledNs > x.modeledNs ? s.modeledNs : x.modeledNs) / 1000.0 / nbOps;
+  return m;
+}
+
+static void nothing() {}
+
+static void record(const char* op, const Config& c, const Metrics& m) {
+  char key[96];
+  snprintf(key, sizeof(key), "%s/cap=%u/cols=%u/type=%s", op, c.capacity, c.nbCols, c.type);
+  results.push_back(std::make_pair(std::string(key), m));
+  printf("%-44s %12.1f %10.1f %10.1f %14.1f\n", key, m.cpuUs, m.reads, m.writes, m.deviceUs);
+}
+
+/********************************************************************************************************************************/
+static char tableName[] = "BT";  // CREATE_TABLE writes in the name
+static char colName[8][3] = {"c0", "c1", "c2", "c3", "c4", "c5", "c6", "c7"};
+
+static bool isDict(const Config& c) { return strncmp(c.type, "DICT", 4) == 0; }
+static bool isChar(const Config& c) { return strncmp(c.type, "CHAR", 4) == 0 || isDict(c); }
+
+static int createTable(MemoryManager& mem, const Config& c, bool withKey = false,
+                       uint8_t options = 0, char* name = tableName) {
+  Column cols[8];
+  char   keyType[16];
+  for (size_t i = 0; i < c.nbCols; i++) {
+    strcpy(cols[i].name, colName[i]);
+    cols[i].type = (char*)c.type;
+  }
+  if (withKey) {  // c0 is the primary key
+    snprintf(keyType, sizeof(keyType), "%s PK", c.type);
+    cols[0].type = keyType;
+  }
+  return mem.CREATE_TABLE(name, c.capacity, c.nbCols, cols, options);
+}
+
+static void insertRow(TableData& t, const Config& c, int value) {
+  for (size_t i = 0; i < c.nbCols; i++) {
+    if (isChar(c)) {
+      // 8 distinct values in a DICT column
+      char text[32];
+      snprintf(text, sizeof(text), "v%d", isDict(c) ? value % 8 : value);
+      t.INSERT(colName[i], text);
+    } else if (strcmp(c.type, "BYTE") == 0) {
+      byte v = value;
+      t.INSERT(colName[i], &v);
+    } else {
+      float v = value;
+      t.INSERT(colName[i], &v);
+    }
+  }
+  t.DONE();
+}
+
+static void fresh(MemoryManager& mem, const Config& c, bool fill, bool withKey = false,
+                  uint8_t options = 0) {
+  mem.clearAll();
+  mem.init();
+  createTable(mem, c, withKey, options);
+  if (fill) {
+    for (int i = 0; i < c.capacity; i++) insertRow(mem.TO(tableName), c, i);
+  }
+}
+
+static int nbPairs = 0;
+
+static void onPair(TableData&, uint8_t, TableData&, uint8_t) { nbPairs += 1; }
+
+/**
+ * @brief Same query (half of the rows, one column) ad hoc and prepared
+ */
+template <typename T>
+static void queries(MemoryManager& mem, const Config& c) {
+  T   half = c.capacity / 2;
+  T   data[MAX_CAP];
+  int nb = 0;
+
+  record("WHERE_SELECT_ALL", c, measure(nothing, [&] {
+           mem.FROM(tableName).WHERE("c0", FILTER::isLessThan, &half).SELECT_ALL("c0", data, nb).DONE();
+         }));
+
+  PreparedQuery<T> q(mem, tableName, "c0", FILTER::isLessThan, &half);
+  int              col = q.COLUMN("c0");
+  record("PREPARED_SELECT_ALL", c, measure(nothing, [&] { q.EXECUTE().SELECT_ALL(col, data, nb); }));
+}
+
+/**
+ * @brief Increase c0 in the half of the rows: one UPDATE per row found by
+ * its position or SET on the whole selection
+ */
+template <typename T>
+static void updates(MemoryManager& mem, const Config& c) {
+  auto full = [&] { fresh(mem, c, true); };
+  T    half = c.capacity / 2;
+  T    one  = 1;
+
+  record("UPDATE_LOOP", c, measure(full, [&] {
+           TableData& t  = mem.TO(tableName).WHERE("c0", FILTER::isLessThan, &half);
+           int        nb = t.COUNT();
+           for (int i = 0; i < nb; i++) {
+             T value;
+             t.SELECT("c0", &value, i);
+             value += one;
+             t.UPDATE("c0", &value, i);
+           }
+           t.DONE();
+         }));
+  record("SET", c, measure(full, [&] {
+           mem.TO(tableName).WHERE("c0", FILTER::isLessThan, &half).SET("c0", increaseBy, &one).DONE();
+         }));
+}
+
+/**
+ * @brief Point lookup of the key in the middle: scan or index of the primary
+ * key, and update of this row by its key
+ */
+template <typename T>
+static void lookups(MemoryManager& mem, const Config& c) {
+  T key = c.capacity / 2;
+  T value;
+
+  fresh(mem, c, true, true);
+  record("WHERE_EQUAL", c, measure(nothing, [&] {
+           mem.FROM(tableName).WHERE("c0", FILTER::isEqualTo, &key).SELECT("c0", &value).DONE();
+         }));
+  record("GET", c, measure(nothing, [&] { mem.FROM(tableName).GET(&key).SELECT("c0", &value).DONE(); }));
+  record("UPSERT", c, measure(nothing, [&] {
+           mem.TO(tableName).UPSERT(&key).INSERT(colName[c.nbCols - 1], &key).DONE();
+         }));
+}
+
+/**
+ * @brief Create the table with an option on c0: "BLOOM", "ZONES"
+ */
+static void withOption(MemoryManager& mem, const Config& c, const char* option) {
+  Column cols[8];
+  char   type0[16];
+  snprintf(type0, sizeof(type0), "%s %s", c.type, option);
+  for (size_t i = 0; i < c.nbCols; i++) {
+    strcpy(cols[i].name, colName[i]);
+    cols[i].type = i == 0 ? type0 : (char*)c.type;
+  }
+  mem.clearAll();
+  mem.init();
+  mem.CREATE_TABLE(tableName, c.capacity, c.nbCols, cols);
+}
+
+/**
+ * @brief Equality lookup of a value which isn't in the table and the last 8
+ * rows (time window): scan of the column, or Bloom filter / zone map of c0.
+ * BLOOM_INSERT and ZONES_INSERT are the cost to keep them
+ */
+template <typename T>
+static void summaries(MemoryManager& mem, const Config& c) {
+  T   absent = c.capacity + 7;
+  T   recent = c.capacity - 8;
+  int nb     = 0;
+
+  auto miss = [&] {
+    nb = mem.FROM(tableName).WHERE("c0", FILTER::isEqualTo, &absent).COUNT();
+    mem.FROM(tableName).DONE();
+  };
+  auto window = [&] {
+    nb = mem.FROM(tableName).WHERE("c0", FILTER::isGreaterOrEqualTo, &recent).COUNT();
+    mem.FROM(tableName).DONE();
+  };
+  auto fill = [&] {
+    for (int i = 0; i < c.capacity; i++) insertRow(mem.TO(tableName), c, i);
+  };
+
+  fresh(mem, c, true);
+  record("WHERE_MISS", c, measure(nothing, miss));
+  record("WHERE_WINDOW", c, measure(nothing, window));
+
+  record("BLOOM_INSERT", c, measure([&] { withOption(mem, c, "BLOOM"); }, fill, c.capacity));
+  record("BLOOM_WHERE_MISS", c, measure(nothing, miss));
+
+  record("ZONES_INSERT", c, measure([&] { withOption(mem, c, "ZONES"); }, fill, c.capacity));
+  record("ZONES_WHERE_WINDOW", c, measure(nothing, window));
+}
+
+/********************************************************************************************************************************/
+// INSERT in a full TABLE_ROLLUP table: each 8 rows overwritten are folded
+// (their average) into a row of a table with the same columns
+static void rollup(MemoryManager& mem, const Config& c) {
+  static char target[] = "BR";
+
+  auto full = [&] {
+    fresh(mem, c, true, false, TABLE_ROLLUP);
+    createTable(mem, c, false, 0, target);
+    mem.ROLLUP(tableName, target, averageOf, 8);
+  };
+
+  record("ROLLUP_INSERT", c, measure(full, [&] {
+           for (int i = 0; i < c.capacity; i++) insertRow(mem.TO(tableName), c, i);
+         },
+                                      c.capacity));
+}
+
+/********************************************************************************************************************************/
+// INSERT in a TABLE_STRIPED table: the columns c1, c3 are on the second
+// device, the program cycles of the two devices overlap
+static void striped(MemoryManager& mem, const Config& c) {
+  auto empty = [&] {
+    memset(external.data(), ZERO, DEVICE2);  // like clearAll on the first device
+    fresh(mem, c, false, false, TABLE_STRIPED);
+  };
+
+  record("STRIPED_INSERT", c, measure(empty, [&] {
+           for (int i = 0; i < c.capacity; i++) insertRow(mem.TO(tableName), c, i);
+         },
+                                       c.capacity));
+
+  record("STRIPED_ASYNC_INSERT", c, measure(empty, [&] {
+           TableData t = mem.OPEN(tableName);
+           mem.ASYNC();
+           for (int i = 0; i < c.capacity; i++) {
+             insertRow(t, c, i);
+             while (mem.poll() || !EEPROM.ready() || !external.ready()) EEPROM.idle(1000000UL);
+           }
+           mem.ASYNC(false);
+         },
+                                             c.capacity));
+}
+
+/********************************************************************************************************************************/
+static void run(MemoryManager& mem, const Config& c) {
+  auto empty = [&] { fresh(mem, c, false); };
+  auto full  = [&] { fresh(mem, c, true); };
+
+  // CREATE_TABLE - configurations which don't fit in the memory are skipped
+  int     status = 0;
+  Metrics m      = measure(
+      [&] {
+        mem.clearAll();
+        mem.init();
+      },
+      [&] { status = createTable(mem, c); });
+  if (status != STATUS_TABLE_CREATED) return;
+  record("CREATE_TABLE", c, m);
+
+  // INSERT: a whole row and DONE, per row
+  record("INSERT", c, measure(empty, [&] {
+           for (int i = 0; i < c.capacity; i++) insertRow(mem.TO(tableName), c, i);
+         },
+                               c.capacity));
+
+  // same with a table kept open
+  record("OPEN_INSERT", c, measure(empty, [&] {
+           TableData t = mem.OPEN(tableName);
+           for (int i = 0; i < c.capacity; i++) insertRow(t, c, i);
+         },
+                                    c.capacity));
+
+  // same in an append log: the laps are written instead of the size
+  record("LOG_INSERT", c, measure([&] { fresh(mem, c, false, false, TABLE_LOG); }, [&] {
+           for (int i = 0; i < 2 * c.capacity; i++) insertRow(mem.TO(tableName), c, i);
+         },
+                                   2 * c.capacity));
+
+  // same in a row-major table: the bytes of a row are written one after the other
+  record("ROWS_INSERT", c, measure([&] { fresh(mem, c, false, false, TABLE_ROWS); }, [&] {
+           for (int i = 0; i < c.capacity; i++) insertRow(mem.TO(tableName), c, i);
+         },
+                                    c.capacity));
+
+  // same with the write queue: loop() does 1 ms of other work between polls
+  // until the next row
+  record("ASYNC_INSERT", c, measure(empty, [&] {
+           TableData t = mem.OPEN(tableName);
+           mem.ASYNC();
+           for (int i = 0; i < c.capacity; i++) {
+             insertRow(t, c, i);
+             while (mem.poll() || !EEPROM.ready()) EEPROM.idle(1000000UL);
+           }
+           mem.ASYNC(false);
+         },
+                                     c.capacity));
+
+  if (c.nbCols > 1) striped(mem, c);
+  rollup(mem, c);
+
+  if (isChar(c)) {
+    // WHERE_TEXT: equality on c0, compared with strcmp or by code (DICT)
+    full();
+    record("WHERE_TEXT", c, measure(nothing, [&] {
+             mem.FROM(tableName).WHERE("c0", FILTER::isEqualTo, "v3").DONE();
+           }));
+    return;  // SELECT_ALL,... work on numerics
+  }
+
+  // SELECT_ALL: every column of the full table
+  full();
+  record("SELECT_ALL", c, measure(nothing, [&] {
+           TableData& t = mem.FROM(tableName);
+           int        nb;
+           for (size_t i = 0; i < c.nbCols; i++) {
+             if (strcmp(c.type, "BYTE") == 0) {
+               byte data[MAX_CAP];
+               t.SELECT_ALL(colName[i], data, nb);
+             } else {
+               float data[MAX_CAP];
+               t.SELECT_ALL(colName[i], data, nb);
+             }
+           }
+           t.DONE();
+         }));
+
+  // PAGE_FIRST / PAGE_LAST: every column of a page of 8 rows, the first one or
+  // the last one (its token is its first slot)
+  auto selectPage = [&](int token) {
+    TableData& t = mem.FROM(tableName).PAGE(8, token);
+    int        nb;
+    for (size_t i = 0; i < c.nbCols; i++) {
+      if (strcmp(c.type, "BYTE") == 0) {
+        byte data[8];
+        t.SELECT_ALL(colName[i], data, nb);
+      } else {
+        float data[8];
+        t.SELECT_ALL(colName[i], data, nb);
+      }
+    }
+    t.DONE();
+  };
+  record("PAGE_FIRST", c, measure(nothing, [&] { selectPage(0); }));
+  record("PAGE_LAST", c, measure(nothing, [&] { selectPage(c.capacity - 8); }));
+
+  // SELECT_HOT: every column of the last row, read again and again (the last
+  // measure of a log), per read of the row
+  record("SELECT_HOT", c, measure(nothing, [&] {
+           for (int n = 0; n < 10; n++) {
+             TableData& t = mem.FROM(tableName);
+             for (size_t i = 0; i < c.nbCols; i++) {
+               if (strcmp(c.type, "BYTE") == 0) {
+                 byte value;
+                 t.SELECT(colName[i], &value, c.capacity - 1);
+               } else {
+                 float value;
+                 t.SELECT(colName[i], &value, c.capacity - 1);
+               }
+             }
+             t.DONE();
+           }
+         },
+                                   10));
+
+  // SELECT_ROWS: every column of each row, one row after the other, per row.
+  // ROWS_SELECT_ROWS: same in a row-major table
+  auto selectRows = [&] {
+    TableData& t = mem.FROM(tableName);
+    for (int r = 0; r < c.capacity; r++) {
+      for (size_t i = 0; i < c.nbCols; i++) {
+        if (strcmp(c.type, "BYTE") == 0) {
+          byte value;
+          t.SELECT(colName[i], &value, r);
+        } else {
+          float value;
+          t.SELECT(colName[i], &value, r);
+        }
+      }
+    }
+    t.DONE();
+  };
+  record("SELECT_ROWS", c, measure(nothing, selectRows, c.capacity));
+  fresh(mem, c, true, false, TABLE_ROWS);
+  record("ROWS_SELECT_ROWS", c, measure(nothing, selectRows, c.capacity));
+  full();
+
+  // WHERE: half of the rows match
+  record("WHERE", c, measure(nothing, [&] {
+           if (strcmp(c.type, "BYTE") == 0) {
+             byte half = c.capacity / 2;
+             mem.FROM(tableName).WHERE("c0", FILTER::isLessThan, &half).DONE();
+           } else {
+             float half = c.capacity / 2;
+             mem.FROM(tableName).WHERE("c0", FILTER::isLessThan, &half).DONE();
+           }
+         }));
+
+  if (strcmp(c.type, "BYTE") == 0) {
+    queries<byte>(mem, c);
+    updates<byte>(mem, c);
+  } else {
+    queries<float>(mem, c);
+    updates<float>(mem, c);
+  }
+
+  // AGGREGATE: average of c0 on the full table
+  record("AGGREGATE", c, measure(nothing, [&] {
+           float avg = 0;
+           mem.FROM(tableName).AGGREGATE("c0", averageOf, &avg).DONE();
+         }));
+
+  // JOIN: the table with itself on c0, each row matches once
+  record("JOIN", c, measure(nothing, [&] {
+           TableData other = mem.OPEN(tableName);
+           mem.FROM(tableName).JOIN(other, "c0", "c0", onPair).DONE();
+         }));
+
+  // ORDER_BY / TOP_K: the whole table on c0, from the highest
+  record("ORDER_BY", c, measure(nothing, [&] { mem.FROM(tableName).ORDER_BY("c0", DESC).DONE(); }));
+  record("TOP_K", c, measure(nothing, [&] { mem.FROM(tableName).TOP_K("c0", 5).DONE(); }));
+
+  // DELETE: the first row of a full table
+  record("DELETE", c, measure(full, [&] { mem.TO(tableName).DELETE(0).DONE(); }));
+
+  // DELETE_ALL: half of a full table
+  record("DELETE_ALL", c, measure(full, [&] {
+           int nb = 0;
+           if (strcmp(c.type, "BYTE") == 0) {
+             byte half = c.capacity / 2;
+             mem.TO(tableName).WHERE("c0", FILTER::isLessThan, &half).DELETE_ALL(nb).DONE();
+           } else {
+             float half = c.capacity / 2;
+             mem.TO(tableName).WHERE("c0", FILTER::isLessThan, &half).DELETE_ALL(nb).DONE();
+           }
+         }));
+
+  // FLOAT16 can't be a primary key or have a Bloom filter
+  if (strcmp(c.type, "BYTE") == 0) {
+    lookups<byte>(mem, c);
+    summaries<byte>(mem, c);
+  } else if (strcmp(c.type, "FLOAT") == 0) {
+    lookups<float>(mem, c);
+    summaries<float>(mem, c);
+  }
+}
+
+/********************************************************************************************************************************/
+static bool loadBaseline(const char* path, std::map<std::string, Metrics>& base) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+
+  char    key[128];
+  Metrics m;
+  while (fscanf(f, "%127s %lf %lf %lf %lf", key, &m.cpuUs, &m.reads, &m.writes, &m.deviceUs) ==
+         5) {
+    base[key] = m;
+  }
+  fclose(f);
+  return true;
+}
+
+static bool writeBaseline(const char* path) {
+  FILE* f = fopen(path, "w");
+  if (!f) return false;
+  for (size_t i = 0; i < results.size(); i++) {
+    const Metrics& m = results[i].second;
+    fprintf(f, "%s %.1f %.1f %.1f %.1f\n", results[i].first.c_str(), m.cpuUs, m.reads, m.writes,
+            m.deviceUs);
+  }
+  fclose(f);
+  return true;
+}
+
+static bool regressed(const char* key, const char* metric, double base, double now, double pct) {
+  if (pct < 0) return false;
+  // the baseline is stored with 1 decimal: compare with the same rounding
+  char rounded[32];
+  snprintf(rounded, sizeof(rounded), "%.1f", now);
+  now = atof(rounded);
+
+  // a small absolute margin avoids failing on tiny values (cpu of a few us)
+  double limit = base * (1.0 + pct / 100.0) + (strcmp(metric, "cpu_us") == 0 ? 5.0 : 0.0);
+  if (now <= limit) return false;
+
+  printf("REGRESSION %s %s: %.1f -> %.1f (limit %.1f)\n", key, metric, base, now, limit);
+  return true;
+}
+
+static int compare(const std::map<std::string, Metrics>& base, double tol, double cpuTol) {
+  int nbFailures = 0;
+  for (size_t i = 0; i < results.size(); i++) {
+    const char* key = results[i].first.c_str();
+    auto        b   = base.find(results[i].first);
+    if (b == base.end()) {
+      printf("NEW %s (not in baseline)\n", key);
+      continue;
+    }
+
+    const Metrics& m = results[i].second;
+    nbFailures += regressed(key, "cpu_us", b->second.cpuUs, m.cpuUs, cpuTol);
+    nbFailures += regressed(key, "reads", b->second.reads, m.reads, tol);
+    nbFailures += regressed(key, "writes", b->second.writes, m.writes, tol);
+    nbFailures += regressed(key, "device_us", b->second.deviceUs, m.deviceUs, tol);
+  }
+  return nbFailures;
+}
+
+/********************************************************************************************************************************/
+int main(int argc, char** argv) {
+  const char* baseline      = nullptr;
+  const char* writeTo       = nullptr;
+  double      tolerance     = 2;
+  double      cpuTolerance  = 100;
+
+  external.setSize(DEVICE2);  // what the tables can use of the second device
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baseline = argv[++i];
+    } else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+      writeTo = argv[++i];
+    } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      tolerance = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--cpu-tolerance") == 0 && i + 1 < argc) {
+      cpuTolerance = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+      i += 1;
+      if (strcmp(argv[i], "i2c") == 0) {
+        EEPROM.setProfile(PROFILE_I2C_24LC256);
+        external.setProfile(PROFILE_I2C_24LC256);
+      } else if (strcmp(argv[i], "avr") != 0) {
+        printf("unknown profile: %s\n", argv[i]);
+        return 2;
+      }
+    } else {
+      printf("unknown option: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  Serial.mute();  // DELETE prints debug informations
+  MemoryManager mem;
+  mem.DEVICE(device);
+
+  printf("%-44s %12s %10s %10s %14s\n", "operation", "cpu_us", "reads", "writes", "device_us");
+
+  const uint8_t     capacities[] = {16, 64, 200};
+  const uint8_t     nbCols[]     = {1, 2, 4};
+  const char* const types[]      = {"BYTE", "FLOAT", "FLOAT16", "CHAR12", "DICT12"};
+
+  for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+    for (size_t c = 0; c < sizeof(capacities); c++) {
+      for (size_t n = 0; n < sizeof(nbCols); n++) {
+        Config conf = {capacities[c], nbCols[n], types[t]};
+        run(mem, conf);
+      }
+    }
+  }
+
+  if (writeTo && !writeBaseline(writeTo)) {
+    printf("can't write %s\n", writeTo);
+    return 2;
+  }
+
+  if (baseline) {
+    std::map<std::string, Metrics> base;
+    if (!loadBaseline(baseline, base)) {
+      printf("can't read %s\n", baseline);
+      return 2;
+    }
+
+    int nbFailures = compare(base, tolerance, cpuTolerance);
+    printf("%d regression(s)\n", nbFailures);
+    return nbFailures == 0 ? 0 : 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @brief Minimal subset of the Arduino core used by TinyDatabase so the library
+ * can be compiled and run on a computer (benchmarks, tools). Only what the
+ * library needs is provided: byte, Print/Stream and a Serial that writes on
+ * the standard output (or nowhere when muted).
+ *
+ */
+
+#ifndef TINY_DATABASE_HOST_ARDUINO
+#define TINY_DATABASE_HOST_ARDUINO
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TINY_DATABASE_HOST 1
+
+typedef uint8_t byte;
+
+/********************************************************************************************************************************/
+/**
+ * @brief Same contract as Arduino Print: a sink of bytes with some helpers
+ * to print numbers and text
+ *
+ */
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printf_("%d", v); }
+  size_t print(unsigned int v) { return printf_("%u", v); }
+  size_t print(long v) { return printf_("%ld", v); }
+  size_t print(unsigned long v) { return printf_("%lu", v); }
+  size_t print(double v, int digits = 2) { return printf_("%.*f", digits, v); }
+  size_t print(unsigned char v) { return printf_("%u", (unsigned)v); }
+  size_t print(bool v) { return printf_("%d", (int)v); }
+
+  size_t println() { return print("\r\n"); }
+  template <typename T>
+  size_t println(T v) {
+    size_t n = print(v);
+    return n + println();
+  }
+
+ private:
+  template <typename T>
+  size_t printf_(const char* fmt, T v) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), fmt, v);
+    return print(buf);
+  }
+  size_t printf_(const char* fmt, int digits, double v) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), fmt, digits, v);
+    return print(buf);
+  }
+};
+
+/********************************************************************************************************************************/
+/**
+ * @brief Same contract as Arduino Stream: a Print we can also read from
+ *
+ */
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read()      = 0;
+  virtual int peek()      = 0;
+
+  size_t readBytes(uint8_t* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+      int c = read();
+      if (c < 0) break;
+      buffer[n++] = (uint8_t)c;
+    }
+    return n;
+  }
+};
+
+/********************************************************************************************************************************/
+/**
+ * @brief Serial of the host: everything goes to a FILE (stdout by default).
+ * Use mute() to silence the library during measures.
+ *
+ */
+class HostSerial : public Stream {
+ public:
+  void begin(unsigned long) {}
+  void mute(bool m = true) { muted = m; }
+
+  size_t write(uint8_t c) override {
+    if (muted) return 1;
+    return fputc(c, stdout) == EOF ? 0 : 1;
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+
+  operator bool() { return true; }
+
+ private:
+  bool muted = false;
+};
+
+static HostSerial Serial;
+
+inline void delay(unsigned long) {}
+
+#endif
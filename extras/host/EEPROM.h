@@ -0,0 +1,266 @@
+/**
+ * @brief Simulated EEPROM for the host. It has the same API than the AVR EEPROM
+ * library (read, write, update, get, put, length) and keeps some counters to
+ * measure what the library does on the memory:
+ *  - reads: bytes read
+ *  - writes: physical writes (program cycles) of a byte
+ *  - modeled time: time the MCU would spend on the memory with the current
+ *    profile. A write starts a program cycle and returns, the next access waits
+ *    for the end of this cycle like eeprom_write_byte/eeprom_read_byte do.
+ *
+ * Like on the ATmega, addresses wrap around the memory size.
+ *
+ * EEPROM is the internal memory. A sketch can make other devices (an external
+ * EEPROM for MemoryManager::DEVICE): each one has its memory, its profile and
+ * its counters, the time goes on the same clock for all of them so the
+ * program cycles of two devices overlap.
+ *
+ * The EEPROM ready interrupt of the internal memory is modeled for
+ * TDB_EE_READY_ISR (avr/interrupt.h).
+ *
+ */
+
+#ifndef TINY_DATABASE_HOST_EEPROM
+#define TINY_DATABASE_HOST_EEPROM
+
+#include "Arduino.h"
+#include "avr/interrupt.h"
+
+#if TDB_CONCURRENT
+#include <mutex>
+// a byte is read or written at once like on the board, and the counters and
+// the clock shared by the tasks stay exact
+#define EEPROM_ACCESS std::lock_guard<std::mutex> eepromAccess(access())
+#else
+#define EEPROM_ACCESS
+#endif
+
+#ifndef E2END
+#define E2END 0x3FF  // ATmega328p: 1 KB
+#endif
+
+/********************************************************************************************************************************/
+/**
+ * @brief Timings of the device in nanoseconds
+ *
+ */
+struct EEPROMProfile {
+  unsigned long readNs;     // time to read a byte
+  unsigned long issueNs;    // time to start a write
+  unsigned long programNs;  // program cycle of a byte (erase + write)
+  unsigned long blockNs;    // time to start a sequential read (readBlock)
+  unsigned long nextNs;     // time to read each byte of a sequential read
+};
+
+// internal EEPROM of the ATmega: no gain to read bytes one after the other
+const EEPROMProfile PROFILE_AVR_INTERNAL = {500, 500, 3300000, 0, 500};
+
+// 24LC256 on I2C at 400 kHz (9 bits per byte on the bus): a random read sends
+// the device, 2 bytes of address and the device again before the data, a
+// sequential read only clocks the next byte
+const EEPROMProfile PROFILE_I2C_24LC256 = {135000, 90000, 5000000, 112500, 22500};
+
+struct EEPROMStats {
+  unsigned long      reads;
+  unsigned long      writes;
+  unsigned long long modeledNs;
+  unsigned long      interrupted;  // accesses during which the EEPROM ready interrupt wrote the memory
+};
+
+/********************************************************************************************************************************/
+class EEPROMClass {
+ public:
+  constexpr EEPROMClass() : s() {}
+
+  uint8_t read(int idx) {
+    EEPROM_ACCESS;
+    state().stats.reads += 1;
+    waitReady();
+    clock().nowNs += state().profile.readNs;
+    return cell(select(idx));
+  }
+
+  void write(int idx, uint8_t val) {
+    EEPROM_ACCESS;
+    state().stats.writes += 1;
+    waitReady();
+    clock().nowNs += state().profile.issueNs;
+    state().busyUntilNs = clock().nowNs + state().profile.programNs;
+    cell(select(idx))   = val;
+  }
+
+  void update(int idx, uint8_t val) {
+    if (read(idx) != val) write(idx, val);
+  }
+
+  /**
+   * @brief Sequential read of len bytes (eeprom_read_block on AVR, one
+   * transaction on I2C)
+   */
+  void readBlock(int idx, uint8_t* buf, size_t len) {
+    if (len == 0) return;
+    EEPROM_ACCESS;
+    state().stats.reads += len;
+    waitReady();
+    clock().nowNs += state().profile.blockNs + len * state().profile.nextNs;
+    for (size_t i = 0; i < len; i++) buf[i] = cell(select(idx + i));
+  }
+
+  template <typename T>
+  T& get(int idx, T& t) {
+    uint8_t* ptr = (uint8_t*)&t;
+    for (size_t i = 0; i < sizeof(T); i++) ptr[i] = read(idx + i);
+    return t;
+  }
+
+  template <typename T>
+  const T& put(int idx, const T& t) {
+    const uint8_t* ptr = (const uint8_t*)&t;
+    for (size_t i = 0; i < sizeof(T); i++) update(idx + i, ptr[i]);
+    return t;
+  }
+
+  uint16_t length() { return state().size; }
+
+  /********************************************************************************************************************************/
+  //// HOST ONLY ////
+
+  /**
+   * @brief Raw access to the memory content without counting anything
+   * (load/save an image, check the content)
+   */
+  uint8_t* data() { return state().memory; }
+
+  void setProfile(const EEPROMProfile& p) {
+    EEPROM_ACCESS;
+    state().profile = p;
+  }
+
+  /**
+   * @brief Size of the memory of the device (E2END + 1 by default). The
+   * memory is blank again
+   */
+  void setSize(size_t n) {
+    EEPROM_ACCESS;
+    free(state().memory);
+    s.ready = false;
+    s.size  = n;
+    state();
+  }
+
+  /**
+   * @brief True if no program cycle is running (like eeprom_is_ready)
+   */
+  bool ready() {
+    EEPROM_ACCESS;
+    return state().busyUntilNs <= clock().nowNs;
+  }
+
+  /**
+   * @brief The MCU does something else during ns: time goes on for the
+   * device but it is not counted in the modeled time
+   */
+  void idle(unsigned long ns) {
+    {
+      EEPROM_ACCESS;
+      clock().nowNs += ns;
+      clock().idleNs += ns;
+    }
+    HostInterrupts::take();  // the memory got ready meanwhile
+  }
+
+  /**
+   * @brief Counters to zero. The clock is the one of all devices: reset them
+   * all
+   */
+  void resetStats() {
+    EEPROM_ACCESS;
+    state().stats       = EEPROMStats();
+    state().busyUntilNs = 0;
+    clock()             = Clock();
+  }
+
+  /**
+   * @brief Counters since the last reset. The modeled time includes the end of
+   * the last program cycle but not the idle time.
+   */
+  EEPROMStats stats() {
+    EEPROM_ACCESS;
+    EEPROMStats st = state().stats;
+    st.modeledNs   = state().busyUntilNs > clock().nowNs ? state().busyUntilNs : clock().nowNs;
+    st.modeledNs -= clock().idleNs;
+    return st;
+  }
+
+ private:
+  struct Clock {
+    unsigned long long nowNs;
+    unsigned long long idleNs;
+  };
+
+  struct State {
+    bool               ready;
+    size_t             size;
+    uint8_t*           memory;
+    EEPROMProfile      profile;
+    EEPROMStats        stats;
+    unsigned long long busyUntilNs;
+    int                eear;  // address of the access running
+  };
+
+  static Clock& clock() { return sharedClock; }
+
+#if TDB_CONCURRENT
+  // one lock for all devices: they share the clock
+  static std::mutex& access() {
+    static std::mutex m;
+    return m;
+  }
+#endif
+
+  // A blank EEPROM is full of 0xFF. State is filled at the first use so it is
+  // valid even during the static initialization of the sketch objects.
+  State& state() {
+    if (!s.ready) blank();
+    return s;
+  }
+
+  // out of line: state() is in each access
+  __attribute__((noinline)) void blank() {
+    if (s.size == 0) s.size = E2END + 1;
+    s.memory = (uint8_t*)malloc(s.size);
+    memset(s.memory, 0xFF, s.size);
+    s.profile = PROFILE_AVR_INTERNAL;
+    s.ready   = true;
+  }
+
+  void waitReady() {
+    if (state().busyUntilNs > clock().nowNs) clock().nowNs = state().busyUntilNs;
+  }
+
+  // the caller got state() before
+  uint8_t& cell(int idx) { return s.memory[(unsigned)idx % s.size]; }
+
+  /**
+   * @brief Address of an access, once the EEPROM ready interrupt had the
+   * chance to run: its write takes the address register of the access
+   */
+  int select(int idx) {
+    s.eear = idx;
+    HostInterrupts::take();
+    if (s.eear != idx) s.stats.interrupted += 1;
+    return s.eear;
+  }
+
+  State        s;
+  static Clock sharedClock;
+};
+
+EEPROMClass::Clock EEPROMClass::sharedClock;
+
+static EEPROMClass EEPROM;
+
+// the EEPROM ready interrupt is the one of the internal memory
+__attribute__((unused)) static bool eepromReadyInterrupt = (HostInterrupts::ready() = [] { return EEPROM.ready(); }, true);
+
+#endif
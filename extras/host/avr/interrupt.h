@@ -0,0 +1,81 @@
+/**
+ * @brief Model of the interrupts of the AVR on the host, enough for
+ * TDB_EE_READY_ISR: the global interrupt flag (SREG, sei, cli), the EEPROM
+ * ready interrupt (EECR, EERIE) and ISR to set its vector.
+ *
+ * The vector runs when the interrupts are enabled, EERIE is set and the
+ * internal EEPROM is ready, at the points where the board could take it: in
+ * each access of the simulated EEPROM, when ATOMIC_BLOCK begins and ends and
+ * when the sketch is idle. An access of the sketch during which the vector
+ * wrote the memory is counted in EEPROMStats::interrupted: on the board the
+ * write changes EEAR under the access.
+ *
+ */
+
+#ifndef TINY_DATABASE_HOST_INTERRUPT
+#define TINY_DATABASE_HOST_INTERRUPT
+
+#include <stdint.h>
+
+const uint8_t SREG_I = 0x80;  // global interrupt flag
+const uint8_t EERIE  = 3;     // EEPROM ready interrupt enable (bit of EECR)
+
+struct HostInterrupts {
+  typedef void (*Vector)();
+  typedef bool (*Ready)();
+
+  // interrupts enabled at the start, like after the init of the Arduino core
+  static uint8_t& sreg() {
+    static uint8_t r = SREG_I;
+    return r;
+  }
+
+  static uint8_t& eecr() {
+    static uint8_t r = 0;
+    return r;
+  }
+
+  static Vector& eeReady() {
+    static Vector v = nullptr;
+    return v;
+  }
+
+  // set by EEPROM.h: the internal EEPROM has no program cycle running
+  static Ready& ready() {
+    static Ready r = nullptr;
+    return r;
+  }
+
+  /**
+   * @brief Run the EEPROM ready vector while it is pending, with the
+   * interrupts disabled like on the board
+   */
+  static void take() {
+    while (eeReady() != nullptr && ready() != nullptr && (sreg() & SREG_I) && (eecr() & (1 << EERIE)) &&
+           ready()()) {
+      sreg() &= ~SREG_I;
+      eeReady()();
+      sreg() |= SREG_I;
+    }
+  }
+};
+
+#define SREG (HostInterrupts::sreg())
+#define EECR (HostInterrupts::eecr())
+
+inline void cli() { SREG &= ~SREG_I; }
+
+inline void sei() {
+  SREG |= SREG_I;
+  HostInterrupts::take();
+}
+
+#define EE_READY_vect eeReady
+
+// ISR(EE_READY_vect) { ... }: the body becomes the vector
+#define ISR(vector)                                                                                    \
+  static void vector##_body();                                                                         \
+  __attribute__((unused)) static bool vector##_set = (HostInterrupts::vector() = vector##_body, true); \
+  static void vector##_body()
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @brief ATOMIC_BLOCK of avr-libc on the host (see avr/interrupt.h): the
+ * interrupts are disabled in the block and the flag is given back at its end,
+ * where a pending interrupt runs. One can also run just before the block.
+ *
+ */
+
+#ifndef TINY_DATABASE_HOST_ATOMIC
+#define TINY_DATABASE_HOST_ATOMIC
+
+#include "../avr/interrupt.h"
+
+struct HostAtomic {
+  HostAtomic() {
+    HostInterrupts::take();
+    saved = SREG;
+    cli();
+  }
+
+  ~HostAtomic() {
+    SREG = saved;
+    HostInterrupts::take();
+  }
+
+  // the block runs once
+  bool once() {
+    if (done) return false;
+    done = true;
+    return true;
+  }
+
+  uint8_t saved = 0;
+  bool    done  = false;
+};
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_BLOCK(type) for (HostAtomic hostAtomic; hostAtomic.once();)
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @brief Random test of the primary key: INSERT (the key given first, last
+ * or not at all), UPSERT, UPDATE of the key, DELETE and DELETE_ALL on a table
+ * with a PK column, and the same statements on a model of the ring of rows.
+ * It checks that:
+ *  - DONE returns false when the model refuses the row (key not given, or
+ *    the key of another row) and that such a row writes nothing
+ *  - the rows of the table are those of the model, slot by slot
+ *  - GET finds the row of each key of the model (the index follows the rows
+ *    moved by DELETE and DELETE_ALL) and no row for the other keys
+ *
+ * Build and run from the root of the library:
+ *
+ *   g++ -std=gnu++11 -fpermissive -Wno-write-strings -O2 -DE2END=0xFFF \
+ *       -Iextras/host -Isrc extras/keys/keys.cpp -o tdb_keys
+ *   ./tdb_keys [seeds] [operations]
+ *
+ */
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+const long KEYS = 40;  // few keys: many of them are already in the table
+
+static MemoryManager mem;
+
+static char KT[] = "KT";
+static char ID[] = "id";
+static char CV[] = "v";
+static char NM[] = "nm";
+static char ST[] = "st";
+
+static const char* NAMES[] = {"", "ab", "kiwi", "plum", "fig"};
+static const char* STATES[] = {"on", "off", "idle"};
+
+struct Row {
+  long        id;
+  int         v;
+  std::string nm;
+  std::string st;
+};
+
+// the slots of the table in their order, like SELECT_ALL reads them
+struct Model {
+  uint8_t          capacity;
+  int              size;
+  std::vector<Row> slots;
+
+  int find(long id) {
+    for (size_t i = 0; i < slots.size(); i++) {
+      if (slots[i].id == id) return i;
+    }
+    return -1;
+  }
+
+  // false if the row is refused
+  bool insert(const Row& r) {
+    int mod   = size % capacity;
+    int found = find(r.id);
+    // the key of the oldest row, about to be overwritten, can be taken
+    if (found >= 0 && !(size >= capacity && found == mod)) return false;
+
+    if ((int)slots.size() < capacity) {
+      slots.push_back(r);
+    } else {
+      slots[mod] = r;
+    }
+    size += 1;
+    if (size == 2 * capacity) size = capacity;
+    return true;
+  }
+
+  void erase(int slot) {
+    slots.erase(slots.begin() + slot);
+    if (size > capacity) size = capacity;
+    size -= 1;
+  }
+};
+
+static long failures = 0;
+
+static void fail(const char* what, unsigned seed, long op, long got, long expected) {
+  if (failures++ < 10) printf("FAIL seed %u op %ld: %s: %ld instead of %ld\n", seed, op, what, got, expected);
+}
+
+static Row randomRow() {
+  Row r;
+  r.id = 1 + rand() % KEYS;
+  r.v  = rand() % 1000;
+  r.nm = NAMES[rand() % 5];
+  r.st = STATES[rand() % 3];
+  return r;
+}
+
+/********************************************************************************************************************************/
+static void check(unsigned seed, long op, Model& m) {
+  long id[256];
+  int  v[256];
+  int  nbId = 0, nbV = 0;
+  mem.FROM(KT).SELECT_ALL(ID, id, nbId).SELECT_ALL(CV, v, nbV).DONE();
+  if (nbId != (int)m.slots.size()) {
+    fail("rows", seed, op, nbId, m.slots.size());
+    return;
+  }
+
+  for (int i = 0; i < nbId; i++) {
+    const Row& r = m.slots[i];
+    char       nm[9] = "", st[9] = "";
+    mem.FROM(KT).SELECT(NM, nm, i).SELECT(ST, st, i).DONE();
+    if (id[i] != r.id) fail("id", seed, op, id[i], r.id);
+    if (v[i] != r.v) fail("v", seed, op, v[i], r.v);
+    if (r.nm != nm) fail("nm", seed, op, i, r.nm.size());
+    if (r.st != st) fail("st", seed, op, i, r.st.size());
+  }
+
+  for (long k = 1; k <= KEYS; k++) {
+    int        got   = -1;
+    TableData& t     = mem.FROM(KT).GET(&k);
+    int        found = t.COUNT();
+    if (found != 0) t.SELECT(CV, &got);
+    t.DONE();
+
+    int slot = m.find(k);
+    if (found != (slot >= 0 ? 1 : 0)) fail("GET found", seed, op, k, slot);
+    if (slot >= 0 && got != m.slots[slot].v) fail("GET value", seed, op, got, m.slots[slot].v);
+  }
+}
+
+/********************************************************************************************************************************/
+static void run(unsigned seed, long nbOps) {
+  srand(seed);
+  mem.clearAll();
+  mem.init();
+
+  Model m;
+  m.capacity = 4 + rand() % 30;
+  m.size     = 0;
+
+  Column cols[4] = {{"v", "INT"}, {"id", "LONG PK"}, {"nm", "CHAR6"}, {"st", "DICT6"}};
+  int    status  = mem.CREATE_TABLE(KT, m.capacity, 4, cols, seed % 2 ? TABLE_ROWS : 0);
+  if (status != STATUS_TABLE_CREATED) {
+    fail("CREATE_TABLE", seed, 0, status, STATUS_TABLE_CREATED);
+    return;
+  }
+
+  for (long op = 0; op < nbOps; op++) {
+    Row r = randomRow();
+    switch (rand() % 10) {
+      case 0:
+      case 1:
+      case 2: {  // the key first
+        char nm[9], st[9];
+        strcpy(nm, r.nm.c_str());
+        strcpy(st, r.st.c_str());
+        bool done = mem.TO(KT).INSERT(ID, &r.id).INSERT(CV, &r.v).INSERT(NM, nm).INSERT(ST, st).DONE();
+        if (done != m.insert(r)) fail("INSERT key first", seed, op, done, !done);
+        break;
+      }
+      case 3:
+      case 4: {  // the key last: nothing is written if it is refused
+        char nm[9], st[9];
+        strcpy(nm, r.nm.c_str());
+        strcpy(st, r.st.c_str());
+        bool done = mem.TO(KT).INSERT(CV, &r.v).INSERT(NM, nm).INSERT(ST, st).INSERT(ID, &r.id).DONE();
+        if (done != m.insert(r)) fail("INSERT key last", seed, op, done, !done);
+        break;
+      }
+      case 5: {  // no key: always refused
+        char nm[9];
+        strcpy(nm, r.nm.c_str());
+        bool done = mem.TO(KT).INSERT(CV, &r.v).INSERT(NM, nm).DONE();
+        if (done) fail("INSERT without key", seed, op, done, false);
+        break;
+      }
+      case 6: {  // UPSERT: the row of the key, else a new row
+        char nm[9], st[9];
+        strcpy(nm, r.nm.c_str());
+        strcpy(st, r.st.c_str());
+        bool done = mem.TO(KT).UPSERT(&r.id).INSERT(CV, &r.v).INSERT(NM, nm).INSERT(ST, st).DONE();
+        int  slot = m.find(r.id);
+        if (slot >= 0) {
+          m.slots[slot] = r;
+        } else {
+          m.insert(r);
+        }
+        if (!done) fail("UPSERT", seed, op, done, true);
+        break;
+      }
+      case 7: {  // new key of a row
+        if (m.slots.empty()) break;
+        int  nth   = rand() % m.slots.size();
+        bool done  = mem.TO(KT).UPDATE(ID, &r.id, nth).DONE();
+        int  found = m.find(r.id);
+        bool free  = found < 0 || found == nth;
+        if (free) m.slots[nth].id = r.id;
+        if (done != free) fail("UPDATE key", seed, op, done, free);
+        break;
+      }
+      case 8: {  // DELETE of one row
+        if (m.slots.empty()) break;
+        int nth = rand() % m.slots.size();
+        mem.TO(KT).DELETE(nth).DONE();
+        m.erase(nth);
+        break;
+      }
+      default: {  // DELETE_ALL of the rows with a small v
+        int limit   = rand() % 300;
+        int deleted = 0;
+        mem.TO(KT).WHERE(CV, isLessThan, &limit).DELETE_ALL(deleted).DONE();
+        int expected = 0;
+        for (int i = m.slots.size() - 1; i >= 0; i--) {
+          if (m.slots[i].v < limit) {
+            m.erase(i);
+            expected += 1;
+          }
+        }
+        if (deleted != expected) fail("DELETE_ALL", seed, op, deleted, expected);
+        break;
+      }
+    }
+
+    check(seed, op, m);
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned nbSeeds = argc > 1 ? atoi(argv[1]) : 30;
+  long     nbOps   = argc > 2 ? atol(argv[2]) : 500;
+
+  Serial.mute();
+  for (unsigned seed = 1; seed <= nbSeeds; seed++) run(seed, nbOps);
+
+  printf("%u seeds, %ld operations each: %s\n", nbSeeds, nbOps, failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+/**
+ * @brief Random test of ROLLUP on a table with a primary key: new rows, rows
+ * refused by the key (the key of another row, no key at all) given first or
+ * last, in a TABLE_ROLLUP table folded into a second table, and the same
+ * statements on a model of the two rings of rows. It checks that:
+ *  - DONE returns false when the model refuses the row
+ *  - the oldest rows are folded once for each new row written over them, and
+ *    never for a refused row
+ *  - the rows of both tables are those of the model, slot by slot
+ *
+ * Build and run from the root of the library:
+ *
+ *   g++ -std=gnu++11 -fpermissive -Wno-write-strings -O2 -DE2END=0xFFF \
+ *       -Iextras/host -Isrc extras/rollup/rollup.cpp -o tdb_rollup
+ *   ./tdb_rollup [seeds] [operations]
+ *
+ */
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static MemoryManager mem;
+
+static char TP[] = "TP";
+static char TH[] = "TH";
+static char ID[] = "id";
+static char CV[] = "v";
+static char CT[] = "t";
+static char ST[] = "st";
+
+static const char* STATES[] = {"on", "off", "idle"};
+
+struct Row {
+  long        id;
+  long        v;
+  float       t;
+  std::string st;
+};
+
+// the slots of a table in their order, like SELECT_ALL reads them
+struct Model {
+  uint8_t          capacity;
+  int              size;
+  std::vector<Row> slots;
+  bool             pk;
+  Model*           into;  // the rollup
+  AGGREGATION      a;
+  uint8_t          nbRows;
+
+  int find(long id) {
+    for (size_t i = 0; i < slots.size(); i++) {
+      if (slots[i].id == id) return i;
+    }
+    return -1;
+  }
+
+  // like TableData::fold
+  template <typename V, typename S>
+  V fold(V Row::*field, int from, int nb) {
+    V first = slots[from].*field;
+    V value = first;
+    S sum   = 0;
+    for (int i = 0; i < nb; i++) {
+      V data = slots[from + i].*field;
+      if ((a == minOf && data < value) || (a == maxOf && data > value)) value = data;
+      sum += (S)(data - first);
+    }
+    if (a == sumOf) return first * nb + (V)sum;
+    if (a == averageOf) return first + (V)(sum / nb);
+    return value;
+  }
+
+  // false if the row is refused
+  bool insert(const Row& r) {
+    int mod = size % capacity;
+    if (pk) {
+      int found = find(r.id);
+      // the key of the oldest row, about to be overwritten, can be taken
+      if (found >= 0 && !(size >= capacity && found == mod)) return false;
+    }
+
+    if (into != nullptr && size >= capacity && mod % nbRows == 0) {
+      int nb = capacity - mod < nbRows ? capacity - mod : nbRows;
+      Row f;
+      f.id = fold<long, long>(&Row::id, mod, nb);
+      f.v  = fold<long, long>(&Row::v, mod, nb);
+      f.t  = fold<float, float>(&Row::t, mod, nb);
+      f.st = slots[mod].st;  // text: the one of the oldest row
+      into->insert(f);
+    }
+
+    if ((int)slots.size() < capacity) {
+      slots.push_back(r);
+    } else {
+      slots[mod] = r;
+    }
+    size += 1;
+    if (size == 2 * capacity) size = capacity;
+    return true;
+  }
+};
+
+static long failures = 0;
+
+static void fail(const char* what, unsigned seed, long op, double got, double expected) {
+  if (failures++ < 10) printf("FAIL seed %u op %ld: %s: %g instead of %g\n", seed, op, what, got, expected);
+}
+
+/********************************************************************************************************************************/
+static void check(unsigned seed, long op, char* name, Model& m) {
+  long  id[256], v[256];
+  float t[256];
+  int   nbId = 0, nbV = 0, nbT = 0;
+  mem.FROM(name).SELECT_ALL(ID, id, nbId).SELECT_ALL(CV, v, nbV).SELECT_ALL(CT, t, nbT).DONE();
+  if (nbId != (int)m.slots.size()) {
+    fail(name, seed, op, nbId, m.slots.size());
+    return;
+  }
+
+  for (int i = 0; i < nbId; i++) {
+    const Row& r = m.slots[i];
+    char       st[9] = "";
+    mem.FROM(name).SELECT(ST, st, i).DONE();
+    if (id[i] != r.id) fail("id", seed, op, id[i], r.id);
+    if (v[i] != r.v) fail("v", seed, op, v[i], r.v);
+    if (t[i] != r.t) fail("t", seed, op, t[i], r.t);
+    if (r.st != st) fail("st", seed, op, i, r.st.size());
+  }
+}
+
+/********************************************************************************************************************************/
+static void run(unsigned seed, long nbOps) {
+  srand(seed);
+  mem.clearAll();
+  mem.init();
+
+  Model history;
+  history.capacity = 100;
+  history.size     = 0;
+  history.pk       = false;
+  history.into     = nullptr;
+
+  // a capacity which isn't a multiple of nbRows on a seed out of four
+  Model m;
+  m.nbRows   = 1 + rand() % 5;
+  m.capacity = 2 + m.nbRows * (rand() % 5) + (seed % 4 == 0 ? rand() % m.nbRows : 0);
+  m.size     = 0;
+  m.pk       = true;
+  m.into     = &history;
+  m.a        = (AGGREGATION)(rand() % 4);
+  if (m.nbRows > m.capacity) m.nbRows = m.capacity;
+
+  Column cols[4]  = {{"v", "LONG"}, {"id", "LONG PK"}, {"t", "FLOAT"}, {"st", "CHAR6"}};
+  Column hcols[4] = {{"id", "LONG"}, {"v", "LONG"}, {"t", "FLOAT"}, {"st", "DICT6"}};
+  int    status   = mem.CREATE_TABLE(TP, m.capacity, 4, cols, TABLE_ROLLUP | (seed % 2 ? TABLE_ROWS : 0));
+  status          = status == STATUS_TABLE_CREATED ? mem.CREATE_TABLE(TH, history.capacity, 4, hcols) : status;
+  if (status != STATUS_TABLE_CREATED) {
+    fail("CREATE_TABLE", seed, 0, status, STATUS_TABLE_CREATED);
+    return;
+  }
+  status = mem.ROLLUP(TP, TH, m.a, m.nbRows);
+  if (status != STATUS_ROLLUP_SET) {
+    fail("ROLLUP", seed, 0, status, STATUS_ROLLUP_SET);
+    return;
+  }
+
+  long next = 1;
+  for (long op = 0; op < nbOps; op++) {
+    Row r;
+    r.v  = rand() % 2000 - 1000;
+    r.t  = (rand() % 400) / 8.0f - 10;
+    r.st = STATES[rand() % 3];
+    char st[9];
+    strcpy(st, r.st.c_str());
+
+    // a new key, else the key of a row: refused but for the oldest one when
+    // the table is full
+    int kind = rand() % 10;
+    r.id     = (kind < 2 && !m.slots.empty()) ? m.slots[rand() % m.slots.size()].id : next++;
+
+    bool done;
+    if (kind == 2) {  // no key: always refused
+      done = mem.TO(TP).INSERT(CV, &r.v).INSERT(CT, &r.t).INSERT(ST, st).DONE();
+      if (done) fail("INSERT without key", seed, op, done, false);
+    } else if (kind % 2 == 0) {  // the key first
+      done = mem.TO(TP).INSERT(ID, &r.id).INSERT(CV, &r.v).INSERT(CT, &r.t).INSERT(ST, st).DONE();
+      if (done != m.insert(r)) fail("INSERT key first", seed, op, done, !done);
+    } else {  // the key last
+      done = mem.TO(TP).INSERT(CV, &r.v).INSERT(CT, &r.t).INSERT(ST, st).INSERT(ID, &r.id).DONE();
+      if (done != m.insert(r)) fail("INSERT key last", seed, op, done, !done);
+    }
+
+    check(seed, op, TP, m);
+    check(seed, op, TH, history);
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned nbSeeds = argc > 1 ? atoi(argv[1]) : 30;
+  long     nbOps   = argc > 2 ? atol(argv[2]) : 500;
+
+  Serial.mute();
+  for (unsigned seed = 1; seed <= nbSeeds; seed++) run(seed, nbOps);
+
+  printf("%u seeds, %ld operations each: %s\n", nbSeeds, nbOps, failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
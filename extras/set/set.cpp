@@ -0,0 +1,353 @@
+/**
+ * @brief Random test of SET and UPDATE_ALL on every kind of column (BOOL,
+ * BYTE, INT, LONG, FLOAT, UINT, ULONG, FLOAT16, FIXED16, CHAR, DICT and the
+ * primary key), on all rows or on those of a WHERE, and the same statements
+ * on a model of the rows. The WHERE compares an INT column, or the FIXED16
+ * one with an int. It checks that:
+ *  - DONE returns false for the statements which are refused (the primary
+ *    key, a CHAR or DICT column with a number, a T of another size than the
+ *    column, a T which isn't a float for FLOAT16 and FIXED16) and that they
+ *    change nothing
+ *  - after each statement, all data of the table are those of the model
+ *  - a PreparedQuery<int> on the FIXED16 column selects the rows of the
+ *    model, the data being compared as float
+ *
+ * Build and run from the root of the library:
+ *
+ *   g++ -std=gnu++11 -fpermissive -Wno-write-strings -O2 -DE2END=0xFFF \
+ *       -Iextras/host -Isrc extras/set/set.cpp -o tdb_set
+ *   ./tdb_set [seeds] [operations]
+ *
+ */
+
+#define TDB_MAX_COLS 12  // a column of each kind
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static const uint8_t TYPE_X = TYPE_FIXED16 + 2;  // FIXED16(100)
+
+static MemoryManager mem;
+
+static char TB[] = "ST";
+static char CK[] = "k";
+static char CO[] = "o";
+static char CB[] = "b";
+static char CI[] = "i";
+static char CL[] = "l";
+static char CF[] = "f";
+static char CU[] = "u";
+static char CW[] = "w";
+static char CH[] = "h";
+static char CX[] = "x";
+static char CC[] = "c";
+static char CD[] = "d";
+
+static const char* TEXTS[] = {"", "ab", "kiwi", "plum", "fig", "lime"};
+
+struct Row {
+  int           k;
+  bool          o;
+  uint8_t       b;
+  int           i;
+  long          l;
+  float         f;
+  unsigned int  u;
+  unsigned long w;
+  uint16_t      h;  // bytes of the FLOAT16
+  uint16_t      x;  // bytes of the FIXED16(100)
+  std::string   c;
+  std::string   d;
+};
+
+static std::vector<Row> rows;
+static bool             selected[256];
+static char*            filtered = nullptr;  // WHERE filtered < limit
+static int              limit    = 0;
+
+static unsigned seed;
+static long     op;
+static long     failures = 0;
+
+static void fail(const char* what, double got, double expected) {
+  if (failures++ < 10) printf("FAIL seed %u op %ld: %s: %g instead of %g\n", seed, op, what, got, expected);
+}
+
+template <typename T>
+static T apply(OPERATION o, T data, T operand) {
+  switch (o) {
+    case setTo:
+      return operand;
+    case increaseBy:
+      return data + operand;
+    case decreaseBy:
+      return data - operand;
+    default:
+      return data * operand;
+  }
+}
+
+// the rows on which the next statement works
+static TableData& statement() {
+  TableData& t = mem.TO(TB);
+  if (filtered != nullptr) t.WHERE(filtered, isLessThan, &limit);
+  return t;
+}
+
+/********************************************************************************************************************************/
+template <typename T>
+static void setNumber(char* name, T Row::*field, OPERATION o, T operand, bool update) {
+  bool done = update ? statement().UPDATE_ALL(name, &operand).DONE() : statement().SET(name, o, &operand).DONE();
+  if (!done) fail(name, done, true);
+
+  for (size_t r = 0; r < rows.size(); r++) {
+    if (selected[r]) rows[r].*field = apply(update ? setTo : o, rows[r].*field, operand);
+  }
+}
+
+static void setQuantized(char* name, uint16_t Row::*field, uint8_t type, OPERATION o, float operand, bool update) {
+  bool done = update ? statement().UPDATE_ALL(name, &operand).DONE() : statement().SET(name, o, &operand).DONE();
+  if (!done) fail(name, done, true);
+
+  for (size_t r = 0; r < rows.size(); r++) {
+    if (!selected[r]) continue;
+    float value    = apply(update ? setTo : o, dequantize(type, rows[r].*field), operand);
+    rows[r].*field = quantize(type, value);
+  }
+}
+
+static void setText(char* name, std::string Row::*field, const char* text) {
+  char data[9];
+  strcpy(data, text);
+  bool done = statement().UPDATE_ALL(name, data).DONE();
+  if (!done) fail(name, done, true);
+
+  for (size_t r = 0; r < rows.size(); r++) {
+    if (selected[r]) rows[r].*field = text;
+  }
+}
+
+// refused: the model doesn't change
+template <typename T>
+static void refused(const char* what, char* name, T operand) {
+  bool done = statement().SET(name, (OPERATION)(rand() % 4), &operand).DONE();
+  if (done) fail(what, done, false);
+}
+
+/********************************************************************************************************************************/
+template <typename T>
+static void checkColumn(char* name, T Row::*field) {
+  T   data[256];
+  int nb = 0;
+  mem.FROM(TB).SELECT_ALL(name, data, nb).DONE();
+  if (nb != (int)rows.size()) fail(name, nb, rows.size());
+  for (int r = 0; r < nb; r++) {
+    if (!(data[r] == rows[r].*field)) fail(name, data[r], rows[r].*field);
+  }
+}
+
+static void checkQuantized(char* name, uint16_t Row::*field, uint8_t type) {
+  float data[256];
+  int   nb = 0;
+  mem.FROM(TB).SELECT_ALL(name, data, nb).DONE();
+  for (int r = 0; r < nb; r++) {
+    float expected = dequantize(type, rows[r].*field);
+    if (!(data[r] == expected) && !(data[r] != data[r] && expected != expected)) fail(name, data[r], expected);
+  }
+}
+
+// the rows of a FIXED16 data greater than an int
+static void checkPrepared(PreparedQuery<int>& query) {
+  int k[256];
+  int nb = 0;
+  query.EXECUTE().SELECT_ALL(query.COLUMN(CK), k, nb).DONE();
+
+  int expected = 0;
+  for (size_t r = 0; r < rows.size(); r++) {
+    if (!(dequantize(TYPE_X, rows[r].x) > limit)) continue;
+    if (expected < nb && k[expected] != rows[r].k) fail("PreparedQuery", k[expected], rows[r].k);
+    expected += 1;
+  }
+  if (nb != expected) fail("PreparedQuery rows", nb, expected);
+}
+
+static void check() {
+  checkColumn(CK, &Row::k);
+  checkColumn(CO, &Row::o);
+  checkColumn(CB, &Row::b);
+  checkColumn(CI, &Row::i);
+  checkColumn(CL, &Row::l);
+  checkColumn(CF, &Row::f);
+  checkColumn(CU, &Row::u);
+  checkColumn(CW, &Row::w);
+  checkQuantized(CH, &Row::h, TYPE_FLOAT16);
+  checkQuantized(CX, &Row::x, TYPE_X);
+
+  for (size_t r = 0; r < rows.size(); r++) {
+    char c[9] = "", d[9] = "";
+    mem.FROM(TB).SELECT(CC, c, r).SELECT(CD, d, r).DONE();
+    if (rows[r].c != c) fail("c", r, rows[r].c.size());
+    if (rows[r].d != d) fail("d", r, rows[r].d.size());
+  }
+}
+
+/********************************************************************************************************************************/
+static void run(long nbOps) {
+  srand(seed);
+  mem.clearAll();
+  mem.init();
+
+  uint8_t capacity = 4 + rand() % 40;
+  Column  cols[12] = {{"k", "INT PK"}, {"o", "BOOL"},    {"b", "BYTE"},         {"i", "INT"},
+                      {"l", "LONG"},   {"f", "FLOAT"},   {"u", "UINT"},         {"w", "ULONG"},
+                      {"h", "FLOAT16"}, {"x", "FIXED16(100)"}, {"c", "CHAR6"}, {"d", "DICT6"}};
+  int     status   = mem.CREATE_TABLE(TB, capacity, 12, cols, seed % 2 ? TABLE_ROWS : 0);
+  if (status != STATUS_TABLE_CREATED) {
+    fail("CREATE_TABLE", status, STATUS_TABLE_CREATED);
+    return;
+  }
+
+  rows.clear();
+  for (int n = 0; n < capacity; n++) {
+    Row   r;
+    float h = (rand() % 2000 - 1000) / 16.0f;
+    float x = (rand() % 20000 - 10000) / 100.0f;
+    r.k     = n;
+    r.o     = rand() % 2;
+    r.b     = rand() & 0xFF;
+    r.i     = rand() % 200 - 100;
+    r.l     = rand() % 100000 - 50000;
+    r.f     = (rand() % 1000) / 8.0f;
+    r.u     = rand() % 60000;
+    r.w     = rand();
+    r.h     = quantize(TYPE_FLOAT16, h);
+    r.x     = quantize(TYPE_X, x);
+    r.c     = TEXTS[rand() % 6];
+    r.d     = TEXTS[rand() % 6];
+
+    char c[9], d[9];
+    strcpy(c, r.c.c_str());
+    strcpy(d, r.d.c_str());
+    bool done = mem.TO(TB)
+                    .INSERT(CK, &r.k)
+                    .INSERT(CO, &r.o)
+                    .INSERT(CB, &r.b)
+                    .INSERT(CI, &r.i)
+                    .INSERT(CL, &r.l)
+                    .INSERT(CF, &r.f)
+                    .INSERT(CU, &r.u)
+                    .INSERT(CW, &r.w)
+                    .INSERT(CH, &h)
+                    .INSERT(CX, &x)
+                    .INSERT(CC, c)
+                    .INSERT(CD, d)
+                    .DONE();
+    if (!done) fail("INSERT", done, true);
+    rows.push_back(r);
+  }
+
+  PreparedQuery<int> query(mem, TB, CX, isGreaterThan, &limit);
+
+  for (op = 0; op < nbOps; op++) {
+    int where = rand() % 4;
+    filtered  = where == 0 ? CI : (where == 1 ? CX : nullptr);
+    limit     = rand() % 200 - 100;
+    for (size_t r = 0; r < rows.size(); r++) {
+      if (where == 0) {
+        selected[r] = rows[r].i < limit;
+      } else if (where == 1) {
+        selected[r] = dequantize(TYPE_X, rows[r].x) < limit;
+      } else {
+        selected[r] = true;
+      }
+    }
+
+    // small operands: the integers don't overflow, a data often goes back to
+    // a small value with setTo
+    OPERATION o      = (OPERATION)(rand() % 4);
+    bool      update = rand() % 5 == 0;
+    int       small  = rand() % 7 - 3;
+    switch (rand() % 17) {
+      case 0:
+        setNumber(CO, &Row::o, o, (bool)(rand() % 2), update);
+        break;
+      case 1:
+        setNumber(CB, &Row::b, o, (uint8_t)small, update);
+        break;
+      case 2:
+        setNumber(CI, &Row::i, o == multiplyBy ? setTo : o, rand() % 200 - 100, update);
+        break;
+      case 3:
+        setNumber(CL, &Row::l, o, (long)small, update);
+        break;
+      case 4:
+        setNumber(CF, &Row::f, o, small / 4.0f, update);
+        break;
+      case 5:
+        setNumber(CU, &Row::u, o, (unsigned int)(small & 3), update);
+        break;
+      case 6:
+        setNumber(CW, &Row::w, o, (unsigned long)rand(), update);
+        break;
+      case 7:
+        setQuantized(CH, &Row::h, TYPE_FLOAT16, o, small / 2.0f, update);
+        break;
+      case 8:
+        setQuantized(CX, &Row::x, TYPE_X, o, small / 4.0f, update);
+        break;
+      case 9:
+        setText(CC, &Row::c, TEXTS[rand() % 6]);
+        break;
+      case 10:
+        setText(CD, &Row::d, TEXTS[rand() % 6]);
+        break;
+      case 11:  // the same value in many rows
+        refused("SET of the primary key", CK, small);
+        break;
+      case 12:  // a code isn't a number
+        refused("SET of a DICT column", CD, (uint8_t)small);
+        break;
+      case 13:
+        refused("SET of a CHAR column", CC, (uint8_t)small);
+        break;
+      case 14:  // the fraction would be lost
+        refused("SET of a FIXED16 column with an int", CX, small);
+        break;
+      case 15:
+        refused("SET of a FLOAT16 column with a long", CH, (long)small);
+        break;
+      default:
+        refused("SET of an INT column with a long", CI, (long)small);
+        break;
+    }
+
+    // the LONG and FLOAT data grow with multiplyBy: back to small values
+    for (size_t r = 0; r < rows.size(); r++) {
+      if (rows[r].l > 1000000L || rows[r].l < -1000000L) {
+        long zero = 0;
+        mem.TO(TB).UPDATE_ALL(CL, &zero).DONE();
+        for (size_t s = 0; s < rows.size(); s++) rows[s].l = 0;
+        break;
+      }
+    }
+
+    check();
+    checkPrepared(query);
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned nbSeeds = argc > 1 ? atoi(argv[1]) : 30;
+  long     nbOps   = argc > 2 ? atol(argv[2]) : 300;
+
+  Serial.mute();
+  for (seed = 1; seed <= nbSeeds; seed++) run(nbOps);
+
+  printf("%u seeds, %ld operations each: %s\n", nbSeeds, nbOps, failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
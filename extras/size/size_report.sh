@@ -0,0 +1,45 @@
+#!/bin/sh
+# Size of extras/size/sketch.cpp for each configuration of the TDB_WITH_*
+# macros. Run from anywhere:
+#
+#   extras/size/size_report.sh
+#
+# CXX, SIZE and CXXFLAGS can be changed (another compiler, other flags). With
+# the host compiler the sizes are those of the host: compare the configurations
+# between them, not with the flash of a board.
+
+cd "$(dirname "$0")/../.." || exit 2
+
+CXX=${CXX:-g++}
+SIZE=${SIZE:-size}
+CXXFLAGS=${CXXFLAGS:-"-std=gnu++11 -fpermissive -Wno-write-strings -w -Os -DE2END=0xFFF \
+-ffunction-sections -fdata-sections -Wl,--gc-sections -Iextras/host -Isrc"}
+OUT=${TMPDIR:-/tmp}/tdb_size.$$
+
+NONE="-DTDB_WITH_WHERE=0 -DTDB_WITH_DELETE=0 -DTDB_WITH_CHAR=0 -DTDB_WITH_PRINT=0 -DTDB_WITH_ROLLUP=0"
+
+printf '%-24s %8s %8s %8s %8s\n' configuration text data bss saved
+base=""
+report() {
+  name=$1
+  shift
+  # shellcheck disable=SC2086
+  if ! $CXX $CXXFLAGS "$@" extras/size/sketch.cpp -o "$OUT"; then
+    echo "$name: build failed"
+    rm -f "$OUT"
+    exit 1
+  fi
+  set -- $($SIZE "$OUT" | tail -n 1)
+  [ -z "$base" ] && base=$1
+  printf '%-24s %8s %8s %8s %8s\n' "$name" "$1" "$2" "$3" "$((base - $1))"
+  rm -f "$OUT"
+}
+
+report default
+report TDB_WITH_WHERE=0 -DTDB_WITH_WHERE=0
+report TDB_WITH_DELETE=0 -DTDB_WITH_DELETE=0
+report TDB_WITH_CHAR=0 -DTDB_WITH_CHAR=0
+report TDB_WITH_PRINT=0 -DTDB_WITH_PRINT=0
+report TDB_WITH_ROLLUP=0 -DTDB_WITH_ROLLUP=0
+# shellcheck disable=SC2086
+report "all 0" $NONE
@@ -0,0 +1,81 @@
+/**
+ * @brief Sketch of a data logger used to measure the size of the library for
+ * each configuration of the TDB_WITH_* macros (size_report.sh). It uses all
+ * the parts of the library which are compiled in, so a part left out shows
+ * what it costs to a sketch which needs it.
+ *
+ * Build from the root of the library, like size_report.sh does:
+ *
+ *   g++ -std=gnu++11 -fpermissive -Wno-write-strings -Os -DE2END=0xFFF \
+ *       -ffunction-sections -fdata-sections -Wl,--gc-sections \
+ *       -Iextras/host -Isrc extras/size/sketch.cpp -o tdb_size
+ *
+ */
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+MemoryManager mem;
+
+/********************************************************************************************************************************/
+void setup() {
+  Serial.begin(9600);
+
+  Column cols[] = {{"tm", "ULONG"}, {"tp", "FLOAT"}, {"hr", "BYTE"}};
+#if TDB_WITH_ROLLUP
+  mem.CREATE_TABLE("TP", 24, 3, cols, TABLE_ROLLUP);
+  mem.CREATE_TABLE("TD", 30, 3, cols);
+  mem.ROLLUP("TP", "TD", averageOf, 24);
+#else
+  mem.CREATE_TABLE("TP", 24, 3, cols);
+#endif
+
+#if TDB_WITH_CHAR
+  Column events[] = {{"tm", "ULONG"}, {"st", "DICT8"}, {"ms", "CHAR12"}};
+  mem.CREATE_TABLE("EV", 8, 3, events);
+#endif
+
+#if TDB_WITH_PRINT
+  mem.printMetaData();
+#endif
+}
+
+void loop() {
+  static unsigned long tm = 0;
+  static uint8_t       hr = 0;
+
+  tm += 60;
+  hr  = (hr + 1) % 24;
+  float tp = 20.5 + hr / 4.0;
+  mem.TO("TP").INSERT("tm", &tm).INSERT("tp", &tp).INSERT("hr", &hr).DONE();
+
+  float avg = 0;
+  uint8_t from = 6;
+#if TDB_WITH_WHERE
+  mem.FROM("TP").WHERE("hr", isGreaterOrEqualTo, &from).AGGREGATE("tp", averageOf, &avg).DONE();
+#else
+  mem.FROM("TP").AGGREGATE("tp", averageOf, &avg).DONE();
+#endif
+
+#if TDB_WITH_CHAR
+  mem.TO("EV").INSERT("tm", &tm).INSERT("st", "ALARM").INSERT("ms", "hot").DONE();
+
+  char ms[13];
+  mem.FROM("EV").SELECT("ms", ms).DONE();
+#endif
+
+#if TDB_WITH_DELETE
+  int nb = 0;
+  if (hr == 0) mem.TO("TP").DELETE_ALL(nb).DONE();
+#endif
+
+  Serial.println(avg);
+}
+
+#if defined(TINY_DATABASE_HOST)
+int main() {
+  setup();
+  for (int i = 0; i < 48; i++) loop();
+  return 0;
+}
+#endif
@@ -0,0 +1,183 @@
+/**
+ * @brief Stress test of TDB_CONCURRENT: writer threads insert rows through TO
+ * (or their own OPEN handle), reader threads read the whole table through FROM
+ * at the same time. Each row is (a, 3 * a, a ^ KEY), a being unique and
+ * increasing for each writer. It checks that:
+ *  - every read for which DONE returns true has whole rows, the rows of each
+ *    writer in the order they were written, and an amount of rows between the
+ *    writes done before the read and those done after it
+ *  - at the end of each round, the table has as many rows as DONE returned
+ *    true for the writers, each row being there once
+ *
+ * The table is never full: a round stops before.
+ *
+ *   stress [rounds] [writers] [readers] [mode]
+ *
+ * mode: "to" (default), "open" (an OPEN handle per writer, a TO statement
+ * every other row), "async" (ASYNC with a thread which calls poll),
+ * "prepared" (the readers run a PreparedQuery which selects all rows)
+ */
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static const uint8_t       CAPACITY   = 150;
+static const unsigned long KEY        = 0xA5A5A5UL;
+static const unsigned long WRITER_GAP = 100000UL;  // first a of each writer: id * WRITER_GAP
+
+static MemoryManager mem;
+
+static char LG[] = "LG";
+static char CA[] = "a";
+static char CB[] = "b";
+static char CC[] = "c";
+
+static int               nbWriters = 4;
+static std::atomic<bool> stop(false);
+static std::atomic<int>  inserted(0);  // DONE true for a writer
+static std::atomic<long> refused(0);   // DONE false for a writer: run again
+static std::atomic<long> validReads(0);
+static std::atomic<long> tornReads(0);
+static std::atomic<long> failures(0);
+
+enum Mode { MODE_TO, MODE_OPEN, MODE_ASYNC, MODE_PREPARED };
+
+static void fail(const char* what, long v1, long v2) {
+  if (failures++ < 10) printf("FAIL %s (%ld, %ld)\n", what, v1, v2);
+}
+
+static void writer(int id, Mode mode) {
+  TableData own = mem.OPEN(LG);
+
+  for (unsigned long i = 1; !stop; i++) {
+    unsigned long a = id * WRITER_GAP + i;
+    unsigned long b = a * 3;
+    unsigned long c = a ^ KEY;
+
+    // the row is written once: a refused statement is run again
+    bool done = false;
+    while (!done && !stop) {
+      // each writer can add one more row after the test
+      if (inserted.load() > CAPACITY - nbWriters) {
+        stop = true;
+        break;
+      }
+      TableData& t = (mode == MODE_OPEN && i % 2 == 0) ? own : mem.TO(LG);
+      done         = t.INSERT(CA, &a).INSERT(CB, &b).INSERT(CC, &c).DONE();
+      if (done) {
+        inserted++;
+      } else {
+        refused++;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+static void reader(Mode mode) {
+  unsigned long a[CAPACITY], b[CAPACITY], c[CAPACITY];
+  unsigned long zero = 0;
+  PreparedQuery<unsigned long> all(mem, LG, CA, isGreaterThan, &zero);
+
+  while (!stop) {
+    int  na = 0, nb = 0, nc = 0;
+    int  before = inserted.load();
+    bool done;
+    if (mode == MODE_PREPARED) {
+      done = all.EXECUTE().SELECT_ALL(0, a, na).SELECT_ALL(1, b, nb).SELECT_ALL(2, c, nc).DONE();
+    } else {
+      done = mem.FROM(LG).SELECT_ALL(CA, a, na).SELECT_ALL(CB, b, nb).SELECT_ALL(CC, c, nc).DONE();
+    }
+    int after = inserted.load();
+    if (!done) {
+      tornReads++;
+      continue;
+    }
+    validReads++;
+
+    if (na != nb || nb != nc) fail("columns of different lengths", na, nb);
+    // a row is counted after its DONE: a read can see one more row per writer
+    if (na < before || na > after + nbWriters) fail("amount of rows", na, before);
+    for (int i = 0; i < na; i++) {
+      if (b[i] != a[i] * 3 || c[i] != (a[i] ^ KEY)) fail("torn row", i, a[i]);
+      for (int j = 0; j < i; j++) {
+        bool sameWriter = a[j] / WRITER_GAP == a[i] / WRITER_GAP;
+        if (sameWriter && a[j] >= a[i]) fail("rows of a writer out of order", a[j], a[i]);
+      }
+    }
+  }
+}
+
+static bool round(int nbReaders, Mode mode) {
+  mem.clearAll();
+  mem.init();
+  stop     = false;
+  inserted = 0;
+
+  Column cols[3] = {{"a", "ULONG"}, {"b", "ULONG"}, {"c", "ULONG"}};
+  int    status  = mem.CREATE_TABLE(LG, CAPACITY, 3, cols);
+  if (status != STATUS_TABLE_CREATED) {
+    printf("CREATE_TABLE: %d\n", status);
+    return false;
+  }
+
+  std::vector<std::thread> threads;
+  if (mode == MODE_ASYNC) {
+    mem.ASYNC(true);
+    threads.emplace_back([] {
+      while (!stop) {
+        mem.poll();
+        EEPROM.idle(1000000);
+        std::this_thread::yield();
+      }
+    });
+  }
+  for (int i = 0; i < nbWriters; i++) threads.emplace_back(writer, i + 1, mode);
+  for (int i = 0; i < nbReaders; i++) threads.emplace_back(reader, mode);
+  for (std::thread& t : threads) t.join();
+  if (mode == MODE_ASYNC) {
+    mem.SYNC();
+    mem.ASYNC(false);
+  }
+
+  // every row written once, and no other one
+  unsigned long a[CAPACITY], b[CAPACITY];
+  int           na = 0, nb = 0;
+  mem.FROM(LG).SELECT_ALL(CA, a, na).SELECT_ALL(CB, b, nb).DONE();
+  if (na != inserted.load()) fail("rows at the end", na, inserted.load());
+  for (int i = 0; i < na; i++) {
+    if (b[i] != a[i] * 3) fail("torn row at the end", i, a[i]);
+    for (int j = 0; j < i; j++) {
+      if (a[j] == a[i]) fail("row written twice", j, a[i]);
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int         rounds    = argc > 1 ? atoi(argv[1]) : 20;
+  nbWriters             = argc > 2 ? atoi(argv[2]) : 4;
+  int         nbReaders = argc > 3 ? atoi(argv[3]) : 2;
+  const char* name      = argc > 4 ? argv[4] : "to";
+  Mode        mode      = MODE_TO;
+  if (strcmp(name, "open") == 0) mode = MODE_OPEN;
+  if (strcmp(name, "async") == 0) mode = MODE_ASYNC;
+  if (strcmp(name, "prepared") == 0) mode = MODE_PREPARED;
+
+  Serial.mute();
+  for (int r = 0; r < rounds; r++) {
+    if (!round(nbReaders, mode)) return 1;
+  }
+
+  printf("%d rounds, %d writers, %d readers, %s: refused writes %ld, valid reads %ld, torn reads %ld\n",
+         rounds, nbWriters, nbReaders, name, refused.load(), validReads.load(), tornReads.load());
+  printf("%s\n", failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
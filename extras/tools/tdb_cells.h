@@ -0,0 +1,82 @@
+/**
+ * @brief Decode the value of a cell (bytes of a column for a row) on a
+ * computer. Boards store values in little endian (AVR, ESP32,...), the size of
+ * the cell is given because it depends on the board (int is 2 bytes on AVR).
+ *
+ */
+
+#ifndef TINY_DATABASE_TOOLS_CELLS
+#define TINY_DATABASE_TOOLS_CELLS
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <TinyDatabase_Arduino.h>
+
+/**
+ * @brief Value of a numeric cell. CHAR cells return 0.
+ */
+static double cellValue(uint8_t type, uint8_t width, const uint8_t* p) {
+  uint32_t raw = 0;
+  for (int i = width < 4 ? width - 1 : 3; i >= 0; i--) raw = (raw << 8) | p[i];
+
+  // FLOAT16, FIXED16: converted like the library does on the board
+  if (isQuantized(type)) return width == 2 ? dequantize(type, raw) : 0;
+
+  switch (type) {
+    case 1:  // BOOL
+    case 2:  // BYTE
+    case 7:  // UINT
+    case 8:  // ULONG
+      return raw;
+
+    case 4:  // INT
+    case 5:  // LONG
+    {
+      // sign extension from the size of the column
+      int bits = 8 * (width < 4 ? width : 4);
+      return bits == 32 ? (int32_t)raw : (int32_t)(raw << (32 - bits)) >> (32 - bits);
+    }
+
+    case 3:  // FLOAT
+    {
+      float value = 0;
+      if (width == sizeof(float)) memcpy(&value, p, sizeof(float));
+      return value;
+    }
+
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Print a text as a quoted CSV field: at most width bytes
+ */
+static void printText(FILE* out, int width, const uint8_t* p) {
+  fputc('"', out);
+  for (int i = 0; i < width && p[i] != '\0'; i++) {
+    if (p[i] == '"') fputc('"', out);
+    fputc(p[i], out);
+  }
+  fputc('"', out);
+}
+
+/**
+ * @brief Print a cell as a CSV field: numbers as they are, text quoted. The
+ * cell of a DICT column is its code: give its value to printText
+ */
+static void printCell(FILE* out, uint8_t type, uint8_t width, const uint8_t* p) {
+  if (type == 3 || isQuantized(type)) {
+    fprintf(out, "%g", cellValue(type, width, p));
+  } else if (type == 9) {  // CHAR
+    fprintf(out, "%c", p[0] ? p[0] : ' ');
+  } else if (isCharArray(type)) {  // CHARnn
+    printText(out, width, p);
+  } else {
+    fprintf(out, "%.0f", cellValue(type, width, p));
+  }
+}
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @brief Decode an image written by EXPORT (MemoryManager or TableData) and
+ * convert each table to CSV. The image is checked frame by frame (crc) and
+ * the program stops at the first corrupted frame.
+ *
+ * Build from the root of the library:
+ *
+ *   g++ -std=gnu++11 -fpermissive -Wno-write-strings -O2 \
+ *       -Iextras/host -Isrc extras/tools/tdb_decode.cpp -o tdb_decode
+ *
+ * Usage:
+ *
+ *   tdb_decode IMAGE           all tables on the standard output
+ *   tdb_decode IMAGE -d DIR    one file DIR/<table>.csv per table
+ *
+ * Values are decoded in little endian (AVR, ESP32,...) with the size of
+ * each column given by the image, so an image of any board can be decoded.
+ *
+ */
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+#include "tdb_cells.h"
+
+#include <string>
+#include <vector>
+
+/********************************************************************************************************************************/
+struct DecodedColumn {
+  char                     name[3];
+  uint8_t                  type;
+  uint8_t                  width;
+  std::vector<std::string> dict;  // values of a DICT column, by code
+};
+
+struct DecodedTable {
+  char                       name[3];
+  uint8_t                    size;
+  uint8_t                    capacity;
+  uint8_t                    nbCols;
+  std::vector<DecodedColumn> cols;
+  int                        width;  // bytes of a row
+  FILE*                      out;
+};
+
+/********************************************************************************************************************************/
+static bool readFrame(FILE* f, uint8_t& type, std::vector<uint8_t>& payload) {
+  int head[2] = {fgetc(f), fgetc(f)};
+  if (head[0] == EOF || head[1] == EOF) return false;
+
+  type = head[0];
+  payload.resize(head[1]);
+  if (fread(payload.data(), 1, payload.size(), f) != payload.size()) return false;
+
+  int crcRead[2] = {fgetc(f), fgetc(f)};
+  if (crcRead[0] == EOF || crcRead[1] == EOF) return false;
+
+  uint16_t crc = crc16(crc16(0xFFFF, type), head[1]);
+  for (size_t i = 0; i < payload.size(); i++) crc = crc16(crc, payload[i]);
+
+  return crc == (crcRead[0] | (crcRead[1] << 8));
+}
+
+/********************************************************************************************************************************/
+int main(int argc, char** argv) {
+  if (argc != 2 && !(argc == 4 && strcmp(argv[2], "-d") == 0)) {
+    printf("usage: %s IMAGE [-d DIR]\n", argv[0]);
+    return 2;
+  }
+  const char* dir = argc == 4 ? argv[3] : nullptr;
+
+  FILE* f = fopen(argv[1], "rb");
+  if (!f) {
+    printf("can't open %s\n", argv[1]);
+    return 2;
+  }
+
+  uint8_t              type;
+  std::vector<uint8_t> p;
+  if (!readFrame(f, type, p) || type != FRAME_BEGIN || p.size() != 4 ||
+      memcmp(p.data(), "TDB", 3) != 0 || p[3] == 0 || p[3] > FRAME_VERSION) {
+    fprintf(stderr, "%s: not an image (version 1 to %d)\n", argv[1], FRAME_VERSION);
+    return 1;
+  }
+
+  DecodedTable         t   = {};
+  std::vector<uint8_t> row;
+  int                  rowSlot = -1;
+  int                  result  = 1;
+
+  // rows are written when they are complete
+  auto flushRow = [&]() {
+    if (rowSlot < 0) return;
+    fprintf(t.out, "%d", rowSlot);
+    for (size_t i = 0, offset = 0; i < t.cols.size(); offset += t.cols[i].width, i++) {
+      fputc(',', t.out);
+      const DecodedColumn& c = t.cols[i];
+      if (isDict(c.type)) {
+        uint8_t     code  = row[offset];
+        std::string value = code < c.dict.size() ? c.dict[code] : "";
+        printText(t.out, value.size(), (const uint8_t*)value.c_str());
+      } else {
+        printCell(t.out, c.type, c.width, &row[offset]);
+      }
+    }
+    fputc('\n', t.out);
+    rowSlot = -1;
+  };
+
+  auto closeTable = [&]() {
+    flushRow();
+    if (t.out && t.out != stdout) fclose(t.out);
+    t.out = nullptr;
+  };
+
+  while (readFrame(f, type, p)) {
+    if (type == FRAME_TABLE && (p.size() == 5 || p.size() == 6)) {
+      closeTable();
+      t          = DecodedTable();
+      t.name[0]  = p[0];
+      t.name[1]  = p[1];
+      t.size     = p[2];
+      t.capacity = p[3];
+      t.nbCols   = p[4];
+    } else if (type == FRAME_COLUMN && (p.size() == 4 || p.size() == 5) &&
+               t.cols.size() < t.nbCols) {
+      DecodedColumn c = {{(char)p[0], (char)p[1], '\0'}, p[2], p[3], {}};
+      t.cols.push_back(c);
+      t.width += c.width;
+
+      if (t.cols.size() == t.nbCols) {
+        // all columns are known: header of the table
+        if (dir) {
+          std::string path = std::string(dir) + "/" + t.name + ".csv";
+          t.out            = fopen(path.c_str(), "w");
+          if (!t.out) {
+            fprintf(stderr, "can't write %s\n", path.c_str());
+            return 2;
+          }
+        } else {
+          t.out = stdout;
+          fprintf(t.out, "# table %s size %u capacity %u\n", t.name, t.size, t.capacity);
+        }
+
+        fprintf(t.out, "slot");
+        for (size_t i = 0; i < t.cols.size(); i++) fprintf(t.out, ",%s", t.cols[i].name);
+        fputc('\n', t.out);
+      }
+    } else if (type == FRAME_DICT && p.size() > 2 && p[0] < t.cols.size()) {
+      DecodedColumn& c    = t.cols[p[0]];
+      uint8_t        code = p[1];
+      if (code >= c.dict.size()) c.dict.resize(code + 1);
+      c.dict[code] = std::string((const char*)&p[2], strnlen((const char*)&p[2], p.size() - 2));
+    } else if (type == FRAME_ROW && p.size() > 3 && t.out) {
+      int slot   = p[0];
+      int offset = p[1] | (p[2] << 8);
+      if (slot != rowSlot) {
+        flushRow();
+        rowSlot = slot;
+        row.assign(t.width, 0);
+      }
+      if (offset + p.size() - 3 > row.size()) break;
+      memcpy(&row[offset], &p[3], p.size() - 3);
+    } else if (type == FRAME_END && p.size() == 3) {
+      closeTable();
+      fprintf(stderr, "%u table(s), %u row(s)\n", p[0], p[1] | (p[2] << 8));
+      result = 0;
+      break;
+    } else {
+      break;
+    }
+  }
+
+  if (result != 0) {
+    closeTable();
+    fprintf(stderr, "%s: corrupted or truncated image\n", argv[1]);
+  }
+  fclose(f);
+  return result;
+}
@@ -0,0 +1,536 @@
+/**
+ * @brief Inspect raw EEPROM dumps (the whole memory of a board, byte 0 first)
+ * without the board. For each image we decode the catalog (tables meta data
+ * at ADDR_TABLES_METADATA), check it and optionally dump or query the tables.
+ * Many images can be given at once to triage them in batch.
+ *
+ * Build from the root of the library:
+ *
+ *   g++ -std=gnu++11 -fpermissive -Wno-write-strings -O2 \
+ *       -Iextras/host -Isrc extras/tools/tdb_inspect.cpp -o tdb_inspect
+ *
+ * Usage:
+ *
+ *   tdb_inspect [options] IMAGE...
+ *
+ *   --catalog              print the catalog (like printMetaData)
+ *   --dump                 print the rows of the tables as CSV
+ *   --table NAME           only this table
+ *   --where COL OP VALUE   only rows which match (OP: < > = <= >= !=)
+ *   --int N                size of int on the board: 2 (AVR, default) or 4
+ *   --second FILE          dump of the second device (MemoryManager::DEVICE) of
+ *                          the board, for the columns of the TABLE_STRIPED tables
+ *   --quiet                only print images with errors
+ *
+ * The program exits with 1 if an image has errors.
+ *
+ */
+
+#include <EEPROM.h>
+#include <TinyDatabase_Arduino.h>
+
+#include "tdb_cells.h"
+
+#include <string>
+#include <vector>
+
+/********************************************************************************************************************************/
+struct Options {
+  bool        catalog = false;
+  bool        dump    = false;
+  bool        quiet   = false;
+  const char* table   = nullptr;
+  const char* whereCol = nullptr;
+  const char* whereOp  = nullptr;
+  const char* whereVal = nullptr;
+  int         intSize  = 2;
+  const char* second   = nullptr;
+};
+
+struct InspectedColumn {
+  char    name[3];
+  uint8_t type;
+  uint8_t width;
+  uint8_t flags;
+  int     dict;  // where the dictionary of a DICT column starts
+};
+
+struct InspectedTable {
+  int                          addr;  // where its meta data start (like ON)
+  char                         name[3];
+  int                          start;
+  uint8_t                      size;
+  uint8_t                      capacity;
+  uint8_t                      options;
+  std::vector<InspectedColumn> cols;
+  int                          rowWidth;
+  int                          stop;  // end of its data, key index, laps, dictionaries, filters
+  int                          start2;  // TABLE_STRIPED: its columns on the second device
+  int                          stop2;
+  int                          rollupTo;    // TABLE_ROLLUP: meta data of the target, -1 if none
+  uint8_t                      rollupAgg;   // its AGGREGATION
+  uint8_t                      rollupRows;  // rows folded into a rollup row
+};
+
+/**
+ * @brief An image and its layout. The offsets of the header are the ones of
+ * the library, relative to the end of the memory, so any size of image works.
+ */
+struct Image {
+  std::vector<uint8_t> bytes;
+  std::vector<uint8_t> second;  // dump of the second device - empty if not given
+
+  int end() const { return bytes.size() - 1; }
+  int at(int addrOfBoard) const { return end() + (addrOfBoard - END_DB); }
+
+  uint8_t read(int addr) const {
+    if (addr >= DEVICE2 && !second.empty()) {
+      return second[(unsigned)(addr - DEVICE2) % second.size()];
+    }
+    return bytes[(unsigned)addr % bytes.size()];
+  }
+  int16_t readInt16(int addr) const { return (int16_t)(read(addr) | (read(addr + 1) << 8)); }
+};
+
+/********************************************************************************************************************************/
+/**
+ * @brief Size of a column on the board. It's deduceSizeof of the library
+ * except for the types whose size depends on the board.
+ */
+static uint8_t widthOf(uint8_t type, const Options& o) {
+  if (type == 4 || type == 7) return o.intSize;  // INT, UINT
+  if (type == 5 || type == 8) return 4;          // LONG, ULONG
+  return deduceSizeof(type);
+}
+
+static bool isKnownType(uint8_t type) { return type >= 1 && deduceSizeof(type) > 0; }
+
+static bool isPrintable(char c) { return c >= 0x21 && c <= 0x7E; }
+
+/********************************************************************************************************************************/
+/**
+ * @brief Decode and check the catalog. Errors are added to the list, tables
+ * with a valid entry are added to the tables.
+ */
+static void decodeCatalog(const Image& img, const Options& o, std::vector<InspectedTable>& tables,
+                          std::vector<std::string>& errors) {
+  char msg[160];
+
+  int     dataEnd = img.readInt16(img.at(ADDR_SIZE_DB));
+  int     metaEnd = img.readInt16(img.at(ADDR_SIZE_METADATA));
+  uint8_t nbT     = img.read(img.at(ADDR_NB_TABLES));
+  int     first   = img.at(ADDR_TABLES_METADATA);
+
+  if (dataEnd == 0 || dataEnd == -1) {
+    errors.push_back("data base not initialized (clearAll/init never called)");
+    return;
+  }
+  if (dataEnd < START_DB || dataEnd > img.end()) {
+    snprintf(msg, sizeof(msg), "end of data %d out of the memory", dataEnd);
+    errors.push_back(msg);
+    return;
+  }
+  if (metaEnd > first || metaEnd < dataEnd - 1) {
+    snprintf(msg, sizeof(msg), "end of meta data %d out of [%d, %d]", metaEnd, dataEnd - 1, first);
+    errors.push_back(msg);
+    return;
+  }
+
+  int szMeta = first;
+  for (size_t i = 0; i < nbT; i++) {
+    if (szMeta - BYTES_TABLES_GEN_METADATA < metaEnd) {
+      snprintf(msg, sizeof(msg), "table %u: meta data at %d after the end of meta data %d",
+               (unsigned)i, szMeta, metaEnd);
+      errors.push_back(msg);
+      return;
+    }
+
+    InspectedTable t;
+    t.addr     = szMeta;
+    t.name[0]  = img.read(szMeta - 0);
+    t.name[1]  = img.read(szMeta - 1);
+    t.name[2]  = '\0';
+    t.start    = img.readInt16(szMeta - 3);
+    t.size     = img.read(szMeta - 5);
+    t.capacity = img.read(szMeta - 6);
+    t.options  = tableFlags(img.read(szMeta - 4));
+    t.rowWidth = 0;
+    t.start2   = -1;
+    t.stop2    = -1;
+    t.rollupTo = -1;
+
+    uint8_t nbCols = img.read(szMeta - 7);
+    szMeta -= BYTES_TABLES_GEN_METADATA;
+
+    if (szMeta - 4 * nbCols < metaEnd) {
+      snprintf(msg, sizeof(msg), "table %s: %u columns go after the end of meta data %d", t.name,
+               nbCols, metaEnd);
+      errors.push_back(msg);
+      return;
+    }
+
+    bool valid = true;
+    if (!isPrintable(t.name[0]) || !isPrintable(t.name[1])) {
+      snprintf(msg, sizeof(msg), "table %u: name is not printable (0x%02X 0x%02X)", (unsigned)i,
+               (uint8_t)t.name[0], (uint8_t)t.name[1]);
+      errors.push_back(msg);
+      valid = false;
+    }
+    if (nbCols == 0 || t.capacity == 0) {
+      snprintf(msg, sizeof(msg), "table %s: %u columns, capacity %u", t.name, nbCols, t.capacity);
+      errors.push_back(msg);
+      valid = false;
+    }
+    if (t.size > 2 * t.capacity) {
+      snprintf(msg, sizeof(msg), "table %s: size %u impossible with capacity %u", t.name, t.size,
+               t.capacity);
+      errors.push_back(msg);
+      valid = false;
+    }
+
+    for (size_t k = 0; k < nbCols; k++) {
+      InspectedColumn c;
+      c.name[0] = img.read(szMeta - 0);
+      c.name[1] = img.read(szMeta - 1);
+      c.name[2] = '\0';
+      c.type    = img.read(szMeta - 3);
+      c.flags   = img.read(szMeta - 2);
+      c.width   = widthOf(c.type, o);
+      if (!(t.options & TABLE_STRIPED)) c.flags &= ~COL_DEVICE2;
+      c.dict    = -1;
+      szMeta -= 4;
+
+      if (!isKnownType(c.type)) {
+        snprintf(msg, sizeof(msg), "table %s: column %u has an unknown type %u", t.name,
+                 (unsigned)k, c.type);
+        errors.push_back(msg);
+        valid = false;
+      }
+      t.cols.push_back(c);
+      t.rowWidth += c.width;
+    }
+
+    int dataStop = t.start;
+    int width2   = 0;  // bytes of a row on the second device
+    for (size_t k = 0; k < t.cols.size(); k++) {
+      if (t.cols[k].flags & COL_DEVICE2)
+        width2 += t.cols[k].width;
+      else
+        dataStop += t.cols[k].width * t.capacity;
+    }
+    for (size_t k = 0; k < t.cols.size(); k++) {
+      if (t.cols[k].flags & COL_PK) dataStop += keySlots(t.capacity);
+    }
+    if ((t.options & TABLE_LOG) && t.capacity != 0) {
+      // append log: the size is found from the laps of the rows (TableData::recoverSize)
+      uint8_t first = img.read(dataStop);
+      int     next  = 1;
+      while (next < t.capacity && img.read(dataStop + next) == first) next++;
+
+      if (first == LAP_EMPTY)
+        t.size = 0;
+      else if (next == t.capacity || img.read(dataStop + t.capacity - 1) != LAP_EMPTY)
+        t.size = t.capacity + next % t.capacity;
+      else
+        t.size = next;
+      dataStop += t.capacity;
+    }
+    for (size_t k = 0; k < t.cols.size(); k++) {
+      if (!isDict(t.cols[k].type)) continue;
+      t.cols[k].dict = dataStop;
+      dataStop += dictBytes(t.cols[k].type);
+    }
+    if (t.options & TABLE_STRIPED) {
+      t.start2 = img.readInt16(dataStop);
+      t.stop2  = t.start2 + width2 * t.capacity;
+      dataStop += 2;
+
+      int deviceEnd = DEVICE2 + (img.second.empty() ? DEVICE2 : (int)img.second.size());
+      if (t.start2 < DEVICE2 || t.stop2 > deviceEnd) {
+        snprintf(msg, sizeof(msg), "table %s: data [%d, %d[ out of the second device [%d, %d[",
+                 t.name, t.start2, t.stop2, DEVICE2, deviceEnd);
+        errors.push_back(msg);
+        valid = false;
+      }
+    }
+    for (size_t k = 0; k < t.cols.size(); k++) {
+      if (t.cols[k].flags & COL_BLOOM) dataStop += bloomBytes(t.capacity);
+    }
+    for (size_t k = 0; k < t.cols.size(); k++) {
+      if (t.cols[k].flags & COL_ZONES) dataStop += zoneBytes(t.capacity, t.cols[k].type);
+    }
+    if (t.options & TABLE_ROLLUP) {
+      t.rollupAgg  = img.read(dataStop + 2);
+      t.rollupRows = img.read(dataStop + 3);
+      if (t.rollupRows != 0) t.rollupTo = img.readInt16(dataStop);
+      dataStop += ROLLUP_BYTES;
+    }
+    t.stop = dataStop;
+    if (t.start < START_DB || dataStop > dataEnd) {
+      snprintf(msg, sizeof(msg), "table %s: data [%d, %d[ out of the data section [%d, %d[",
+               t.name, t.start, dataStop, START_DB, dataEnd);
+      errors.push_back(msg);
+      valid = false;
+    }
+
+    for (size_t k = 0; k < tables.size(); k++) {
+      const InspectedTable& other     = tables[k];
+      int                   otherStop = other.stop;
+      if (strcmp(other.name, t.name) == 0) {
+        snprintf(msg, sizeof(msg), "table %s: defined twice", t.name);
+        errors.push_back(msg);
+        valid = false;
+      }
+      if (t.start < otherStop && other.start < dataStop) {
+        snprintf(msg, sizeof(msg), "table %s: data [%d, %d[ overlap table %s [%d, %d[", t.name,
+                 t.start, dataStop, other.name, other.start, otherStop);
+        errors.push_back(msg);
+        valid = false;
+      }
+      if (t.start2 >= 0 && other.start2 >= 0 && t.start2 < other.stop2 &&
+          other.start2 < t.stop2) {
+        snprintf(msg, sizeof(msg), "table %s: data [%d, %d[ overlap table %s [%d, %d[", t.name,
+                 t.start2, t.stop2, other.name, other.start2, other.stop2);
+        errors.push_back(msg);
+        valid = false;
+      }
+    }
+
+    if (valid) tables.push_back(t);
+  }
+
+  if (szMeta != metaEnd) {
+    snprintf(msg, sizeof(msg), "catalog stops at %d but end of meta data is %d", szMeta, metaEnd);
+    errors.push_back(msg);
+  }
+}
+
+/********************************************************************************************************************************/
+/**
+ * @brief Value of a cell of a DICT column from its dictionary: "" if the code
+ * isn't a value of the dictionary
+ */
+static void dictValue(const Image& img, const InspectedColumn& c, uint8_t code, char* text) {
+  uint8_t width = c.type - TYPE_DICT;
+  text[0]       = '\0';
+  if (code >= DICT_ENTRIES) return;
+
+  for (uint8_t k = 0; k < code + 1; k++) {
+    if (img.read(c.dict + k * width) == DICT_FREE) return;  // after the last value
+  }
+  for (size_t k = 0; k < width; k++) text[k] = img.read(c.dict + code * width + k);
+  text[width] = '\0';
+}
+
+/**
+ * @brief Address of a cell, like TableData::jumpToColumn: column-major or
+ * row-major (TABLE_ROWS), on the second device for the columns of a
+ * TABLE_STRIPED table
+ */
+static int cellAddr(const InspectedTable& t, size_t col, uint8_t slot) {
+  bool    byRow  = t.options & TABLE_ROWS;
+  uint8_t device = t.cols[col].flags & COL_DEVICE2;
+  int     addr   = (device ? t.start2 : t.start) + slot * (byRow ? t.rowWidth : t.cols[col].width);
+  for (size_t i = 0; i < col; i++) {
+    if ((t.cols[i].flags & COL_DEVICE2) != device) continue;
+    addr += t.cols[i].width * (byRow ? 1 : t.capacity);
+  }
+  return addr;
+}
+
+/**
+ * @brief Check if a row match the --where option
+ */
+static bool match(const Image& img, const InspectedTable& t, uint8_t slot, const Options& o) {
+  if (!o.whereCol) return true;
+
+  for (size_t i = 0; i < t.cols.size(); i++) {
+    const InspectedColumn& c = t.cols[i];
+    if (strcmp(c.name, o.whereCol) != 0) continue;
+
+    uint8_t cell[256];
+    for (size_t k = 0; k < c.width; k++) cell[k] = img.read(cellAddr(t, i, slot) + k);
+
+    int cmp;
+    if (isCharArray(c.type)) {
+      char text[256];
+      memcpy(text, cell, c.width);
+      text[c.width] = '\0';
+      cmp           = strcmp(text, o.whereVal);
+    } else if (isDict(c.type)) {
+      char text[256];
+      dictValue(img, c, cell[0], text);
+      cmp = strcmp(text, o.whereVal);
+    } else {
+      double v = cellValue(c.type, c.width, cell);
+      double w = atof(o.whereVal);
+      cmp      = v < w ? -1 : (v > w ? 1 : 0);
+    }
+
+    const char* op = o.whereOp;
+    if (strcmp(op, "<") == 0) return cmp < 0;
+    if (strcmp(op, ">") == 0) return cmp > 0;
+    if (strcmp(op, "=") == 0) return cmp == 0;
+    if (strcmp(op, "<=") == 0) return cmp <= 0;
+    if (strcmp(op, ">=") == 0) return cmp >= 0;
+    if (strcmp(op, "!=") == 0) return cmp != 0;
+    return false;
+  }
+
+  return false;  // column not in this table
+}
+
+static bool hasColumn(const InspectedTable& t, const char* name) {
+  for (size_t i = 0; i < t.cols.size(); i++) {
+    if (strcmp(t.cols[i].name, name) == 0) return true;
+  }
+  return false;
+}
+
+static void dumpTable(const char* file, const Image& img, const InspectedTable& t,
+                      const Options& o) {
+  printf("# %s table %s\nslot", file, t.name);
+  for (size_t i = 0; i < t.cols.size(); i++) printf(",%s", t.cols[i].name);
+  printf("\n");
+
+  uint8_t amount = t.size >= t.capacity ? t.capacity : t.size;
+  for (size_t slot = 0; slot < amount; slot++) {
+    if (!match(img, t, slot, o)) continue;
+
+    printf("%u", (unsigned)slot);
+    for (size_t i = 0; i < t.cols.size(); i++) {
+      const InspectedColumn& c = t.cols[i];
+      uint8_t                cell[256];
+      for (size_t k = 0; k < c.width; k++) cell[k] = img.read(cellAddr(t, i, slot) + k);
+
+      printf(",");
+      if ((c.flags & COL_DEVICE2) && img.second.empty()) {
+        printf("?");  // no dump of the second device
+      } else if (isDict(c.type)) {
+        char text[256];
+        dictValue(img, c, cell[0], text);
+        printText(stdout, strlen(text), (const uint8_t*)text);
+      } else {
+        printCell(stdout, c.type, c.width, cell);
+      }
+    }
+    printf("\n");
+  }
+}
+
+static void printCatalog(const InspectedTable& t) {
+  printf("  table %s at %d: start %d, size %u, capacity %u, %u columns, %d bytes per row%s%s",
+         t.name, t.addr, t.start, t.size, t.capacity, (unsigned)t.cols.size(), t.rowWidth,
+         (t.options & TABLE_LOG) ? ", append log" : "",
+         (t.options & TABLE_ROWS) ? ", row-major" : "");
+  if (t.options & TABLE_STRIPED) printf(", striped (second device at %d)", t.start2 - DEVICE2);
+  if (t.rollupTo >= 0) {
+    static const char* aggregations[] = {"sum", "min", "max", "average"};
+    printf(", rollup of %u rows (%s) into the table at %d", t.rollupRows,
+           t.rollupAgg < 4 ? aggregations[t.rollupAgg] : "?", t.rollupTo);
+  }
+  printf("\n");
+  for (size_t i = 0; i < t.cols.size(); i++) {
+    printf("    column %s: type %u, sizeof %u%s%s%s%s\n", t.cols[i].name, t.cols[i].type,
+           t.cols[i].width, (t.cols[i].flags & COL_PK) ? ", primary key" : "",
+           (t.cols[i].flags & COL_DEVICE2) ? ", second device" : "",
+           (t.cols[i].flags & COL_BLOOM) ? ", bloom filter" : "",
+           (t.cols[i].flags & COL_ZONES) ? ", zone map" : "");
+  }
+}
+
+/********************************************************************************************************************************/
+static bool load(const char* file, std::vector<uint8_t>& bytes) {
+  FILE* f = fopen(file, "rb");
+  if (!f) return false;
+
+  uint8_t buf[4096];
+  size_t  n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) bytes.insert(bytes.end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+static bool inspect(const char* file, const Options& o) {
+  Image img;
+  if (!load(file, img.bytes)) {
+    printf("%s: ERROR can't open\n", file);
+    return false;
+  }
+  if (o.second && !load(o.second, img.second)) {
+    printf("%s: ERROR can't open\n", o.second);
+    return false;
+  }
+
+  if (img.bytes.size() < 64) {
+    printf("%s: ERROR image of %u bytes is too small\n", file, (unsigned)img.bytes.size());
+    return false;
+  }
+
+  std::vector<InspectedTable> tables;
+  std::vector<std::string>    errors;
+  decodeCatalog(img, o, tables, errors);
+
+  if (!errors.empty()) {
+    printf("%s: ERROR %u error(s)\n", file, (unsigned)errors.size());
+    for (size_t i = 0; i < errors.size(); i++) printf("  %s\n", errors[i].c_str());
+  } else if (!o.quiet) {
+    printf("%s: OK %u bytes, %u table(s)\n", file, (unsigned)img.bytes.size(),
+           (unsigned)tables.size());
+  }
+
+  for (size_t i = 0; i < tables.size(); i++) {
+    if (o.table && strcmp(o.table, tables[i].name) != 0) continue;
+    if (o.whereCol && !hasColumn(tables[i], o.whereCol)) continue;
+    if (o.catalog) printCatalog(tables[i]);
+    if (o.dump) dumpTable(file, img, tables[i], o);
+  }
+
+  return errors.empty();
+}
+
+int main(int argc, char** argv) {
+  Options                  o;
+  std::vector<const char*> files;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--catalog") == 0) {
+      o.catalog = true;
+    } else if (strcmp(argv[i], "--dump") == 0) {
+      o.dump = true;
+    } else if (strcmp(argv[i], "--quiet") == 0) {
+      o.quiet = true;
+    } else if (strcmp(argv[i], "--table") == 0 && i + 1 < argc) {
+      o.table = argv[++i];
+    } else if (strcmp(argv[i], "--int") == 0 && i + 1 < argc) {
+      o.intSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--second") == 0 && i + 1 < argc) {
+      o.second = argv[++i];
+    } else if (strcmp(argv[i], "--where") == 0 && i + 3 < argc) {
+      o.whereCol = argv[++i];
+      o.whereOp  = argv[++i];
+      o.whereVal = argv[++i];
+      o.dump     = true;
+    } else if (argv[i][0] == '-') {
+      printf("unknown option: %s\n", argv[i]);
+      return 2;
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+
+  if (files.empty()) {
+    printf("usage: %s [--catalog] [--dump] [--table NAME] [--where COL OP VALUE] [--int N] "
+           "[--second FILE] [--quiet] IMAGE...\n",
+           argv[0]);
+    return 2;
+  }
+
+  int nbErrors = 0;
+  for (size_t i = 0; i < files.size(); i++) {
+    if (!inspect(files[i], o)) nbErrors += 1;
+  }
+
+  if (files.size() > 1) printf("%u image(s), %d with errors\n", (unsigned)files.size(), nbErrors);
+  return nbErrors == 0 ? 0 : 1;
+}
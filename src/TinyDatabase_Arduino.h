@@ -16,9 +16,62 @@
 #include <EEPROM.h>
 #include <string.h>
 
+// the EEPROM ready interrupt writes the queue (on the host: its model in extras/host)
+#if defined(TDB_EE_READY_ISR) && (defined(__AVR__) || defined(TINY_DATABASE_HOST))
+#define TDB_READY_ISR 1
+#else
+#define TDB_READY_ISR 0
+#endif
+
+#if TDB_READY_ISR
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#define TDB_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)  // the queue is shared with the interrupt
+#elif TDB_CONCURRENT
+#define TDB_ATOMIC for (QueueGuard tdbQueue; tdbQueue.once();)  // the queue is shared by the tasks
+#else
+#define TDB_ATOMIC
+#endif
+
+#if TDB_CONCURRENT
+#if defined(__AVR__)
+#error "TDB_CONCURRENT needs std::mutex and std::atomic: not on AVR"
+#endif
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Lock of the queue of the asynchronous writes for the block after
+ * TDB_ATOMIC, like ATOMIC_BLOCK with the interrupt: the readers of the other
+ * tasks look at the queue while a writer or poll changes it
+ *
+ */
+struct QueueGuard {
+  QueueGuard() { mutex().lock(); }
+  ~QueueGuard() { mutex().unlock(); }
+
+  // the block runs once
+  bool once() {
+    if (done) return false;
+    done = true;
+    return true;
+  }
+
+  static std::mutex& mutex() {
+    static std::mutex m;
+    return m;
+  }
+
+  bool done = false;
+};
+#endif
+
 /********************************************************************************************************************************/
 /**
-   @brief Define each memory size based on the board
+   @brief Define each memory size based on the board. Addresses stored in the
+   memory itself are always written on 2 bytes (int16_t) so the layout doesn't
+   depend on the size of int of the board (or of the host for tools)
 
 */
 const int START_DB             = 1;                       // Where the database start
@@ -37,11 +90,21 @@ const int BYTES_TABLES_GEN_METADATA = 8;                  // Bytes used to store
 const int STATUS_TABLE_CREATED = -200;  // Table creation succeeded
 const int STATUS_TABLE_EXIST   = -201;  // Table already exist
 const int STATUS_SUF_MEMORY    = -204;  // Sufficient memory - memory is available
+const int STATUS_IMPORTED      = -205;  // Image imported
+const int STATUS_ROLLUP_SET    = -206;  // Rollup declared
 
 const int STATUS_TABLE_NOT_FOUND  = -401;  // Table not found
 const int STATUS_COL_NOT_FOUND    = -402;  // Column not found
 const int STATUS_INSUF_MEMORY     = -404;  // Insufficient memory
 const int STATUS_MAX_CAP_EXCEEDED = -405;  // Maximum of capacity exceeded
+const int STATUS_BAD_IMAGE        = -406;  // Image corrupted (crc) or not an image
+const int STATUS_TABLE_MISMATCH   = -407;  // Table of the image differs from the existing one
+const int STATUS_MAX_COLS_EXCEEDED = -408;  // Maximum of columns exceeded
+const int STATUS_BAD_KEY           = -409;  // Primary key must be one numeric column
+const int STATUS_BAD_STRIPE        = -410;  // TABLE_STRIPED needs a DEVICE and a column-major table
+const int STATUS_BAD_BLOOM         = -411;  // BLOOM needs a numeric column
+const int STATUS_BAD_ZONES         = -412;  // ZONES needs a numeric column
+const int STATUS_BAD_ROLLUP        = -413;  // ROLLUP needs a TABLE_ROLLUP table and another table
 
 /********************************************************************************************************************************/
 /**
@@ -58,6 +121,191 @@ const uint8_t ACTION_WHERE      = 5;
 
 const uint8_t MAX_CHAR = 30;
 const uint8_t MAX_CAP  = 255;
+const uint8_t SEL_SIZE = (MAX_CAP + 7) / 8;  // bytes of a selection: one bit per row
+
+/**
+   @brief Each TableData holds the columns of its table without heap, so the
+   number of columns of a table is limited. Define TDB_MAX_COLS before including
+   the library to change it. MemoryManager keeps the address of the last
+   TDB_CATALOG_CACHE tables used to not search them again in the meta data.
+*/
+#ifndef TDB_MAX_COLS
+#define TDB_MAX_COLS 8
+#endif
+
+#ifndef TDB_CATALOG_CACHE
+#define TDB_CATALOG_CACHE 4
+#endif
+
+const uint8_t MAX_COLS = TDB_MAX_COLS;
+
+/**
+   @brief Options of a column, given after its type: {"id", "BYTE PK"}. They are
+   kept in the meta data of the column (flags)
+*/
+const uint8_t COL_PK      = 0x01;  // Primary key: values are unique and indexed (GET / UPSERT)
+const uint8_t COL_DEVICE2 = 0x02;  // Data of the column on the second device (TABLE_STRIPED)
+const uint8_t COL_BLOOM   = 0x04;  // Bloom filter of the values: WHERE isEqualTo skips absent values
+const uint8_t COL_ZONES   = 0x08;  // Min and max of each ZONE_ROWS rows: WHERE skips the zones out
+
+const uint8_t KEY_EMPTY = 0xFF;  // Free entry of the index of a primary key
+
+const uint8_t BLOOM_HASHES = 3;  // Bits set by a value in its byte of the Bloom filter of a column
+const uint8_t ZONE_ROWS    = 16;  // Rows of a zone of a ZONES column
+
+/**
+   @brief Types of column which keep a float in 2 bytes: "FLOAT16" (half
+   precision, 3 significant digits) and "FIXED16(scale)" (the value * scale
+   rounded to an integer, scale 1, 10, 100, 1000 or 10000). Values are
+   converted when they are written and read, so we use them with float data
+*/
+const uint8_t TYPE_FLOAT16 = 6;
+const uint8_t TYPE_FIXED16 = 240;  // FIXED16(10^n) is TYPE_FIXED16 + n, after all CHARnn
+
+/**
+   @brief "DICTnn" columns keep text like CHARnn for columns with a few distinct
+   values ("OK", "WARN",...): each value is stored once in a dictionary of
+   DICT_ENTRIES entries of nn bytes after the data of the table, and each row
+   keeps the code of its value (1 byte). A value which can't be added to a full
+   dictionary is not stored (the data reads "")
+*/
+const uint8_t TYPE_DICT    = 209;  // DICTnn is TYPE_DICT + nn, nn up to MAX_CHAR
+const uint8_t DICT_ENTRIES = 16;
+const uint8_t DICT_FREE    = 0xFF;  // First byte of a free entry of a dictionary
+const uint8_t DICT_NONE    = 0xFF;  // Code of a row without value
+
+/**
+   @brief Options of a table, given at CREATE_TABLE and kept in its meta data
+*/
+const uint8_t TABLE_LOG  = 0x01;  // Append log: INSERT doesn't write the size of the table
+const uint8_t TABLE_ROWS = 0x02;  // Row-major: the data of a row are one after the other
+const uint8_t TABLE_STRIPED = 0x04;  // Columns 1, 3, 5,... on the second device (DEVICE)
+const uint8_t TABLE_ROLLUP  = 0x08;  // Oldest rows folded into another table (ROLLUP)
+
+const uint8_t ROLLUP_BYTES = 4;  // Rollup of a TABLE_ROLLUP table: its target, AGGREGATION and rows
+
+/**
+   @brief Addresses of the second device (MemoryManager::DEVICE) are DEVICE2 +
+   its own address: 16 KB of it can be used by the tables
+*/
+const int DEVICE2 = 0x4000;
+
+const uint8_t LAP_EMPTY = 0;  // Lap of a row never written in an append log
+
+/**
+   @brief Amount of bytes which can wait to be written in asynchronous mode
+   (MemoryManager::ASYNC), 3 bytes of SRAM each. Define TDB_WRITE_QUEUE before
+   including the library to change it. Define TDB_EE_READY_ISR to write them
+   from the EEPROM ready interrupt (AVR) instead of MemoryManager::poll.
+*/
+#ifndef TDB_WRITE_QUEUE
+#define TDB_WRITE_QUEUE 32
+#endif
+
+/**
+   @brief Define TDB_CONCURRENT to 1 before including the library when many
+   tasks of an RTOS (ESP32, ARM) work on the data base: statements which write
+   (INSERT, UPDATE, DELETE, CREATE_TABLE,...) take a lock, one writer at once,
+   from their first write to DONE. Statements which only read never take it:
+   DONE returns false if a write ran during their reads, the data they gave
+   may be torn and the statement is run again (see WriterLock). Each task has
+   its own TableData for TO / FROM. It needs std::mutex (not on AVR) and leaves
+   out the row cache, which changes at each read.
+*/
+#ifndef TDB_CONCURRENT
+#define TDB_CONCURRENT 0
+#endif
+
+/**
+   @brief Rows kept in SRAM by SELECT (see RowCache) and the bytes kept of each
+   row: the columns after TDB_ROW_CACHE_BYTES are always read from the memory.
+   Define TDB_ROW_CACHE before including the library to change it, 0 to disable
+   the cache.
+*/
+#ifndef TDB_ROW_CACHE
+#define TDB_ROW_CACHE (TDB_CONCURRENT ? 0 : 2)
+#endif
+
+#if TDB_CONCURRENT && TDB_ROW_CACHE > 0
+#error "TDB_CONCURRENT needs TDB_ROW_CACHE 0: reads of the other tasks change the cache"
+#endif
+
+#ifndef TDB_ROW_CACHE_BYTES
+#define TDB_ROW_CACHE_BYTES 16
+#endif
+
+/**
+   @brief Bytes read at once by the scans of a column (WHERE, SELECT_ALL,
+   AGGREGATE): a buffer of this size is kept on the stack during the scan.
+   Define TDB_SCAN_BLOCK before including the library to change it.
+*/
+#ifndef TDB_SCAN_BLOCK
+#define TDB_SCAN_BLOCK 32
+#endif
+
+#if TDB_SCAN_BLOCK < 4 || TDB_SCAN_BLOCK > 255
+#error "TDB_SCAN_BLOCK must be between 4 and 255"
+#endif
+
+/**
+   @brief Parts of the library which can be left out of the program to save
+   flash and SRAM, when the sketch doesn't use them. Define them to 0 before
+   including the library:
+   - TDB_WITH_WHERE: WHERE and PreparedQuery
+   - TDB_WITH_DELETE: DELETE and DELETE_ALL
+   - TDB_WITH_CHAR: CHARnn and DICTnn columns and the char* methods (the
+     numeric columns of a table which has text columns still work)
+   - TDB_WITH_PRINT: printMetaData and the messages on Serial
+   - TDB_WITH_ROLLUP: ROLLUP (a TABLE_ROLLUP table keeps its oldest rows)
+   A call to a method left out doesn't compile. See extras/size for the
+   size of each configuration.
+*/
+#ifndef TDB_WITH_WHERE
+#define TDB_WITH_WHERE 1
+#endif
+
+#ifndef TDB_WITH_DELETE
+#define TDB_WITH_DELETE 1
+#endif
+
+#ifndef TDB_WITH_CHAR
+#define TDB_WITH_CHAR 1
+#endif
+
+#ifndef TDB_WITH_PRINT
+#define TDB_WITH_PRINT 1
+#endif
+
+#ifndef TDB_WITH_ROLLUP
+#define TDB_WITH_ROLLUP 1
+#endif
+
+/********************************************************************************************************************************/
+/**
+   @brief Binary image of the data base used by EXPORT and IMPORT. An image is a
+   sequence of frames: [type][length][payload: length bytes][crc low][crc high]
+   The crc (CRC-16/CCITT) is computed on type, length and payload.
+
+   - 'B' begin:  "TDB" and the version of the format
+   - 'T' table:  name (2), size, capacity, number of columns, options.
+                 Images of version 1 and 2 have no options
+   - 'C' column: name (2), type, sizeof, flags - one per column after its table.
+                 Images of version 1 have no flags
+   - 'D' dict:   position of the column, code, bytes of the value - one per
+                 value of the dictionary of a DICT column, after the columns
+   - 'R' row:    slot, offset in the row (2), bytes of the row: columns one after
+                 the other. A row can be split on many frames
+   - 'E' end:    number of tables, number of rows (2)
+*/
+const uint8_t FRAME_BEGIN  = 'B';
+const uint8_t FRAME_TABLE  = 'T';
+const uint8_t FRAME_COLUMN = 'C';
+const uint8_t FRAME_DICT   = 'D';
+const uint8_t FRAME_ROW    = 'R';
+const uint8_t FRAME_END    = 'E';
+
+const uint8_t FRAME_VERSION     = 4;
+const uint8_t FRAME_MAX_PAYLOAD = 32;  // IMPORT holds a frame in SRAM before writing it
 
 /********************************************************************************************************************************/
 /**
@@ -72,6 +320,137 @@ enum FILTER {
   isNotEqualTo
 };
 
+/**
+   @brief Order of data given by ORDER_BY and TOP_K
+*/
+enum ORDER {
+  ASC,  // from the smallest to the highest
+  DESC  // from the highest to the smallest
+};
+
+/**
+   @brief Operations of SET: the new value of a column from its current value
+   and an operand
+*/
+enum OPERATION {
+  setTo,       // col = operand
+  increaseBy,  // col = col + operand
+  decreaseBy,  // col = col - operand
+  multiplyBy   // col = col * operand
+};
+
+/**
+   @brief Aggregations of AGGREGATE: one value from the data of a column
+*/
+enum AGGREGATION {
+  sumOf,     // sum of the data
+  minOf,     // the smallest data
+  maxOf,     // the highest data
+  averageOf  // sum of the data / amount of data
+};
+
+/********************************************************************************************************************************/
+/**
+ * @brief Comparison done by a FILTER. We choose it once before scanning a
+ * column instead of switching on the FILTER for each row
+ *
+ * @tparam T Type of the data compared
+ */
+template <typename T>
+struct FilterTest {
+  typedef bool (*Test)(const T& data, const T& value);
+
+  static bool lessThan(const T& data, const T& value) { return data < value; }
+  static bool greaterThan(const T& data, const T& value) { return data > value; }
+  static bool equalTo(const T& data, const T& value) { return data == value; }
+  static bool lessOrEqualTo(const T& data, const T& value) { return data <= value; }
+  static bool greaterOrEqualTo(const T& data, const T& value) { return data >= value; }
+  static bool notEqualTo(const T& data, const T& value) { return data != value; }
+
+  /**
+   * @brief The comparison of a filter
+   *
+   * @param f A filter - enum value
+   * @return Test nullptr if the filter is unknown
+   */
+  static Test of(FILTER f) {
+    switch (f) {
+      case FILTER::isLessThan:
+        return lessThan;
+      case FILTER::isGreaterThan:
+        return greaterThan;
+      case FILTER::isEqualTo:
+        return equalTo;
+      case FILTER::isLessOrEqualTo:
+        return lessOrEqualTo;
+      case FILTER::isGreaterOrEqualTo:
+        return greaterOrEqualTo;
+      case FILTER::isNotEqualTo:
+        return notEqualTo;
+      default:
+        return nullptr;
+    }
+  }
+};
+
+/********************************************************************************************************************************/
+/**
+ * @brief Computation done by an OPERATION, chosen once like FilterTest
+ *
+ * @tparam T Type of the column data
+ */
+template <typename T>
+struct Operation {
+  typedef T (*Apply)(const T& data, const T& operand);
+
+  static T to(const T&, const T& operand) { return operand; }
+  static T plus(const T& data, const T& operand) { return data + operand; }
+  static T minus(const T& data, const T& operand) { return data - operand; }
+  static T times(const T& data, const T& operand) { return data * operand; }
+
+  /**
+   * @brief The computation of an operation
+   *
+   * @param op An operation - enum value
+   * @return Apply nullptr if the operation is unknown
+   */
+  static Apply of(OPERATION op) {
+    switch (op) {
+      case OPERATION::setTo:
+        return to;
+      case OPERATION::increaseBy:
+        return plus;
+      case OPERATION::decreaseBy:
+        return minus;
+      case OPERATION::multiplyBy:
+        return times;
+      default:
+        return nullptr;
+    }
+  }
+};
+
+/**
+ * @brief True for the types which hold the data of FLOAT16 and FIXED16 columns
+ * without truncating them
+ *
+ * @tparam T
+ */
+template <typename T>
+struct IsFloat {
+  static const bool value = false;
+};
+
+template <>
+struct IsFloat<float> {
+  static const bool value = true;
+};
+
+template <>
+struct IsFloat<double> {
+  static const bool value = true;
+};
+
 /********************************************************************************************************************************/
 /**
  * @brief Custom println function as key - value to give to data
@@ -82,9 +461,11 @@ enum FILTER {
  */
 template <typename T>
 static void PRINT(char name[], T data) {
+#if TDB_WITH_PRINT
   Serial.print(name);
   Serial.print(": ");
   Serial.println(data);
+#endif
 }
 
 /**
@@ -96,23 +477,199 @@ static void PRINT(char name[], T data) {
  * @return uint8_t
  */
 uint8_t typeIDNum(char* type) {
-  if (strcmp(type, "BOOL") == 0) return 1;
-  if (strcmp(type, "BYTE") == 0) return 2;
-  if (strcmp(type, "FLOAT") == 0) return 3;
-  if (strcmp(type, "INT") == 0) return 4;
-  if (strcmp(type, "LONG") == 0) return 5;
-  // if ( strcmp(type, "STRING") == 0) return 6;
-  if (strcmp(type, "UINT") == 0) return 7;
-  if (strcmp(type, "ULONG") == 0) return 8;
-  if (strncmp(type, "CHAR", 4) == 0) {
-    if (strlen(type) == 4) return 9;
-    char nb[] = {type[4], type[5]};
-    return 9 + atoi(nb);
+  // options of the column come after the type: "BYTE PK"
+  char   t[16];
+  size_t len = strcspn(type, " ");
+  if (len >= sizeof(t)) return 0;
+  memcpy(t, type, len);
+  t[len] = '\0';
+
+  if (strcmp(t, "BOOL") == 0) return 1;
+  if (strcmp(t, "BYTE") == 0) return 2;
+  if (strcmp(t, "FLOAT") == 0) return 3;
+  if (strcmp(t, "INT") == 0) return 4;
+  if (strcmp(t, "LONG") == 0) return 5;
+  if (strcmp(t, "FLOAT16") == 0) return TYPE_FLOAT16;
+  if (strcmp(t, "UINT") == 0) return 7;
+  if (strcmp(t, "ULONG") == 0) return 8;
+#if TDB_WITH_CHAR
+  if (strncmp(t, "CHAR", 4) == 0) {
+    if (len == 4) return 9;
+    int n = atoi(t + 4);
+    return (n > 0 && 9 + n <= TYPE_DICT) ? 9 + n : 0;
+  }
+  if (strncmp(t, "DICT", 4) == 0) {
+    int n = atoi(t + 4);
+    return (n > 0 && n <= MAX_CHAR) ? TYPE_DICT + n : 0;
+  }
+#endif
+  if (strcmp(t, "FIXED16") == 0) return TYPE_FIXED16;
+  if (strncmp(t, "FIXED16(", 8) == 0 && t[len - 1] == ')') {
+    long scale = atol(t + 8);
+    long s     = 1;
+    for (uint8_t n = 0; n <= 4; n++, s *= 10) {
+      if (scale == s) return TYPE_FIXED16 + n;
+    }
   }
 
   return 0;
 }
 
+/**
+ * @brief Options given after the type of a column, separated by a space:
+ * "BYTE PK". See COL_*
+ *
+ * @param type Char sequence from the user to indicate column type
+ * @return uint8_t Flags of the column
+ */
+uint8_t columnFlags(char* type) {
+  uint8_t     flags = 0;
+  const char* word  = strchr(type, ' ');
+  while (word != nullptr) {
+    word += 1;
+    size_t len = strcspn(word, " ");
+    if (len == 2 && strncmp(word, "PK", 2) == 0) flags |= COL_PK;
+    if (len == 5 && strncmp(word, "BLOOM", 5) == 0) flags |= COL_BLOOM;
+    if (len == 5 && strncmp(word, "ZONES", 5) == 0) flags |= COL_ZONES;
+
+    word = strchr(word, ' ');
+  }
+
+  return flags;
+}
+
+/**
+ * @brief Options of a table from the byte of its meta data. Tables created
+ * before the options have there 0 (clearAll) or an erased byte (0xFF)
+ *
+ * @param stored Byte of the meta data
+ * @return uint8_t Options of the table - see TABLE_*
+ */
+uint8_t tableFlags(uint8_t stored) { return stored == 0xFF ? 0 : stored; }
+
+/**
+ * @brief Columns of FLOAT16 or FIXED16: their data is converted
+ *
+ * @param type ID of the type of the column
+ * @return bool
+ */
+bool isQuantized(uint8_t type) {
+  return type == TYPE_FLOAT16 || (type >= TYPE_FIXED16 && type <= TYPE_FIXED16 + 4);
+}
+
+/**
+ * @brief Columns of CHARnn: their data is a char array (read and written with
+ * the char* methods). Known even without TDB_WITH_CHAR: the size of the rows
+ * of a table created with text columns stays right
+ *
+ * @param type ID of the type of the column
+ * @return bool
+ */
+bool isCharArray(uint8_t type) { return type > 9 && type <= TYPE_DICT; }
+
+/**
+ * @brief Columns of DICTnn: each row keeps the code of its value in the
+ * dictionary of the column
+ *
+ * @param type ID of the type of the column
+ * @return bool
+ */
+bool isDict(uint8_t type) { return type > TYPE_DICT && type <= TYPE_DICT + MAX_CHAR; }
+
+/**
+ * @brief Bytes of the dictionary of a column: 0 if it isn't a DICT column
+ *
+ * @param type ID of the type of the column
+ * @return int
+ */
+int dictBytes(uint8_t type) { return isDict(type) ? DICT_ENTRIES * (type - TYPE_DICT) : 0; }
+
+/**
+ * @brief 2 bytes of a FLOAT16 or FIXED16 column from a float. FLOAT16 is
+ * rounded to the nearest half float (infinity out of +-65504), FIXED16 to the
+ * nearest integer of value * scale (limited to -32768..32767)
+ *
+ * @param type ID of the type of the column
+ * @param value Value to store
+ * @return uint16_t
+ */
+uint16_t quantize(uint8_t type, float value) {
+  if (type != TYPE_FLOAT16) {
+    float scaled = value;
+    for (uint8_t n = TYPE_FIXED16; n < type; n++) scaled *= 10;
+
+    if (!(scaled > -32768.5f)) return (uint16_t)(int16_t)-32768;  // NaN too
+    if (scaled >= 32767.5f) return 32767;
+    return (uint16_t)(int16_t)(scaled < 0 ? (long)(scaled - 0.5f) : (long)(scaled + 0.5f));
+  }
+
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint16_t sign = (bits >> 16) & 0x8000;
+  int16_t  exp  = ((bits >> 23) & 0xFF) - 127 + 15;
+  uint32_t mant = bits & 0x7FFFFF;
+
+  if (((bits >> 23) & 0xFF) == 0xFF) return sign | 0x7C00 | (mant ? 0x200 : 0);  // inf, NaN
+  if (exp >= 31) return sign | 0x7C00;
+  if (exp <= 0) {
+    // subnormal (or zero): the implicit bit goes in the mantissa
+    if (exp < -10) return sign;
+    mant |= 0x800000;
+    uint8_t  shift = 14 - exp;
+    uint32_t half  = mant >> shift;
+    uint32_t rest  = mant & ((1UL << shift) - 1);
+    uint32_t mid   = 1UL << (shift - 1);
+    if (rest > mid || (rest == mid && (half & 1))) half += 1;
+    return sign | half;
+  }
+
+  // to nearest even: a carry goes in the exponent, up to infinity
+  uint16_t half = sign | (exp << 10) | (mant >> 13);
+  uint32_t rest = mant & 0x1FFF;
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half += 1;
+  return half;
+}
+
+/**
+ * @brief The float stored in 2 bytes of a FLOAT16 or FIXED16 column
+ *
+ * @param type ID of the type of the column
+ * @param raw Bytes of the column
+ * @return float
+ */
+float dequantize(uint8_t type, uint16_t raw) {
+  if (type != TYPE_FLOAT16) {
+    float value = (int16_t)raw;
+    for (uint8_t n = TYPE_FIXED16; n < type; n++) value /= 10;
+    return value;
+  }
+
+  uint32_t sign = (uint32_t)(raw & 0x8000) << 16;
+  uint8_t  exp  = (raw >> 10) & 0x1F;
+  uint32_t mant = raw & 0x3FF;
+  uint32_t bits;
+
+  if (exp == 31) {
+    bits = sign | 0x7F800000 | (mant << 13);
+  } else if (exp != 0) {
+    bits = sign | ((uint32_t)(exp - 15 + 127) << 23) | (mant << 13);
+  } else if (mant == 0) {
+    bits = sign;
+  } else {
+    // subnormal: normalized for the float
+    int8_t e = -14;
+    while (!(mant & 0x400)) {
+      mant <<= 1;
+      e -= 1;
+    }
+    bits = sign | ((uint32_t)(e + 127) << 23) | ((mant & 0x3FF) << 13);
+  }
+
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
 /**
  * @brief When we read data type from column informations, we deduce the amount
  * of uint8_t which match
@@ -121,6 +678,8 @@ uint8_t typeIDNum(char* type) {
  * @return uint8_t
  */
 uint8_t deduceSizeof(uint8_t type) {
+  if (isQuantized(type)) return sizeof(uint16_t);
+  if (isDict(type)) return sizeof(uint8_t);
   if (type == 1) return sizeof(bool);
   if (type == 2) return sizeof(byte);
   if (type == 3) return sizeof(float);
@@ -130,844 +689,4280 @@ uint8_t deduceSizeof(uint8_t type) {
   if (type == 7) return sizeof(unsigned int);
   if (type == 8) return sizeof(unsigned long);
   if (type == 9) return sizeof(char);
-  if (type > 9) return (type - 9) * sizeof(char);
+  if (isCharArray(type)) return (type - 9) * sizeof(char);
 
   return 0;
 }
 
-/********************************************************************************************************************************/
 /**
-   @brief This structure represent a column of a table that user
-  instanciate to create a column
-*/
-struct Column {
-  char  name[3];
-  char* type;
-};
+ * @brief Amount of entries of the index of a primary key: one byte per entry
+ * stored after the data of the table. A third of them stay free so a value is
+ * found in a few reads
+ *
+ * @param capacity Capacity of the table
+ * @return int
+ */
+int keySlots(uint8_t capacity) { return capacity + capacity / 2 + 1; }
 
 /**
- * @brief Will be used by an instance of TableData
- * to hold easily column informations
+ * @brief Bytes of the Bloom filter of a BLOOM column: one byte per row, each
+ * value sets BLOOM_HASHES bits of one of them. About 8 % of the absent values
+ * are still searched in the column
  *
+ * @param capacity Capacity of the table
+ * @return int
  */
-struct AllColumn {
-  char    name[3];
-  uint8_t type;
-};
+int bloomBytes(uint8_t capacity) { return capacity; }
 
-/*
-struct ArrayOfChar {
-  char* value;
+/**
+ * @brief Bytes of the zone map of a ZONES column: the min and the max of each
+ * ZONE_ROWS rows, with the size of the data of the column
+ *
+ * @param capacity Capacity of the table
+ * @param type ID of the type of the column
+ * @return int
+ */
+int zoneBytes(uint8_t capacity, uint8_t type) {
+  return (capacity + ZONE_ROWS - 1) / ZONE_ROWS * 2 * deduceSizeof(type);
+}
+
+/**
+ * @brief Update a CRC-16/CCITT (poly 0x1021, start with 0xFFFF) with a byte.
+ * Used to check frames of EXPORT / IMPORT images
+ *
+ * @param crc Current crc
+ * @param data New byte
+ * @return uint16_t
+ */
+uint16_t crc16(uint16_t crc, uint8_t data) {
+  crc ^= (uint16_t)data << 8;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  }
+  return crc;
+}
+
+/********************************************************************************************************************************/
+/**
+ * @brief Hits and misses of the row cache since the last reset
+ *
+ */
+struct CacheStats {
+  unsigned long hits;
+  unsigned long misses;
 };
-*/
 
 /********************************************************************************************************************************/
 /**
- * @brief TableData is the second most important class of this library.
- * It is used to work on a table: read a table data, display them
- * and delete operations. The main class MemoryManager has an instance of
- * this to work on the data base.
+ * @brief Rows read again and again (the last measure, the config,...) are kept
+ * in SRAM: SELECT reads them from the cache instead of the memory. A row is
+ * found by its table (address of the table in meta data) and its slot, each
+ * column of the row is kept when it is read the first time.
  *
- * We use inline methods for function definitions to kep all code in one file.
+ * Each write of the memory (Storage::write) in the data of a table removes
+ * the rows of this table from the cache, so the cache can't give an old value
+ * whatever writes (INSERT, UPDATE, DELETE, IMPORT, another TableData,...). When
+ * the cache is full, the least recently used row is replaced.
  *
  */
-class TableData {
+class RowCache {
  public:
-  TableData() {}
+  RowCache() { clear(); }
 
-  /********************************************************************************************************************************/
   /**
-   * @brief Construct a new Table Data object
-   * We work on a table after getting its information's address
-   * from Meta data parts. When we go to the Meta data parts
-   * we can have all global informations about a table: size, capacity
-   * where we start store its data in memory, columns name,...
+   * @brief Bytes of a column of a row
    *
-   *
-   * @param c_addr Where the current table data informations storage started
+   * @param table Address of the table in meta data
+   * @param slot Index of the row in the table
+   * @param col Position of the column in the table
+   * @param offset Position of the column in the row
+   * @return const uint8_t* nullptr if they are not in the cache
    */
-  TableData(int c_addr) {
-    if (c_addr >= 0) {
-      addr      = c_addr;
-      int _addr = addr;
+  const uint8_t* find(int table, uint8_t slot, uint8_t col, uint8_t offset) {
+    for (size_t i = 0; i < TDB_ROW_CACHE; i++) {
+      CachedRow& r = rows[i];
+      if (r.table == table && r.slot == slot && (r.cols & (1 << col))) {
+        r.used = ++clock;
+        counters.hits += 1;
+        return r.data + offset;
+      }
+    }
 
-      name[0] = char(EEPROM.read(_addr - 0));
-      name[1] = char(EEPROM.read(_addr - 1));
-      name[2] = '\0';  // char(EEPROM.read(szMeta - 2));
+    counters.misses += 1;
+    return nullptr;
+  }
 
-      start = 0;
-      EEPROM.get(_addr - 3, start);
+  /**
+   * @brief Keep the bytes of a column of a row, just read from the memory
+   *
+   * @param table Address of the table in meta data
+   * @param start First byte of the data of the table
+   * @param end Byte after the data of the table
+   * @param slot Index of the row in the table
+   * @param col Position of the column in the table
+   * @param offset Position of the column in the row
+   * @param data Bytes of the column
+   * @param nbBytes Size of the column
+   */
+  void keep(int table, int start, int end, uint8_t slot, uint8_t col, uint8_t offset,
+            const uint8_t* data, uint8_t nbBytes) {
+    CachedRow* r = nullptr;
+    for (size_t i = 0; i < TDB_ROW_CACHE && r == nullptr; i++) {
+      if (rows[i].table == table && rows[i].slot == slot) r = &rows[i];
+    }
 
-      size = EEPROM.read(_addr - 5);
+    if (r == nullptr) {
+      // a free row or the least recently used
+      r = &rows[0];
+      for (size_t i = 1; i < TDB_ROW_CACHE && r->table >= 0; i++) {
+        if (rows[i].table < 0 || (uint16_t)(clock - rows[i].used) > (uint16_t)(clock - r->used)) {
+          r = &rows[i];
+        }
+      }
+      r->table = table;
+      r->start = start;
+      r->end   = end;
+      r->slot  = slot;
+      r->cols  = 0;
+    }
 
-      capacity = EEPROM.read(_addr - 6);
+    memcpy(r->data + offset, data, nbBytes);
+    r->cols |= 1 << col;
+    r->used = ++clock;
+  }
 
-      modSize = size % capacity;
+  /**
+   * @brief A byte of the memory is written: the rows of its table are removed
+   *
+   * @param idx Address of the byte
+   */
+  void invalidate(int idx) {
+    for (size_t i = 0; i < TDB_ROW_CACHE; i++) {
+      if (rows[i].table >= 0 && idx >= rows[i].start && idx < rows[i].end) rows[i].table = -1;
+    }
+  }
 
-      currentAction = ACTION_SELECT;
-      indexElt      = (int*)malloc(capacity * sizeof(int));
-      initIndexElt();
+  void clear() {
+    for (size_t i = 0; i < TDB_ROW_CACHE; i++) {
+      rows[i].table = -1;
+    }
+  }
+
+  /**
+   * @brief Hits and misses since the last reset
+   *
+   * @param reset Set the counters to zero after reading them
+   * @return CacheStats
+   */
+  CacheStats stats(bool reset = false) {
+    CacheStats s = counters;
+    if (reset) counters = CacheStats();
+    return s;
+  }
+
+ private:
+  struct CachedRow {
+    int      table;  // address of the table in meta data - negative: free
+    int      start;  // data of the table: a write in [start, end) removes the row
+    int      end;
+    uint8_t  slot;
+    uint16_t cols;  // one bit per column kept
+    uint16_t used;  // clock of the last use
+    uint8_t  data[TDB_ROW_CACHE_BYTES];
+  };
+
+  CachedRow  rows[TDB_ROW_CACHE > 0 ? TDB_ROW_CACHE : 1];
+  uint16_t   clock    = 0;
+  CacheStats counters = CacheStats();
+};
+
+static RowCache ROW_CACHE;
+
+/********************************************************************************************************************************/
+/**
+ * @brief A second memory for the tables created with TABLE_STRIPED (an
+ * external EEPROM, a FRAM,...): the sketch implements these methods on the
+ * driver of its device and gives the object to MemoryManager::DEVICE. Like
+ * the internal EEPROM, a write starts the program cycle of the byte and
+ * returns: it only waits for the end of the previous write of the device.
+ *
+ */
+class StorageDevice {
+ public:
+  virtual uint8_t read(int idx)              = 0;
+  virtual void    write(int idx, uint8_t val) = 0;
+  virtual bool    ready()                    = 0;  // no program cycle is running
+  virtual int     length()                   = 0;
+
+  // sequential read: override it if the device has one (I2C, SPI)
+  virtual void readBlock(int idx, uint8_t* buf, uint8_t len) {
+    for (uint8_t i = 0; i < len; i++) buf[i] = read(idx + i);
+  }
+};
+
+/********************************************************************************************************************************/
+/**
+ * @brief All accesses of the library to the memory go through Storage. It
+ * has the API of EEPROM (read, write, update, get, put) and can delay the
+ * writes: in asynchronous mode a write is kept in a queue in SRAM and returns
+ * at once. The queue is written in the order of the writes, one byte each time
+ * the EEPROM is ready (poll or the EEPROM ready interrupt), so the MCU doesn't
+ * wait for the 3.3 ms of each byte. Reads look at the queue first: we always
+ * read what we wrote.
+ *
+ * Bytes still in the queue are lost if the board is reset: call sync before.
+ *
+ * Addresses from DEVICE2 are on the second device. The queue keeps the order
+ * of the writes of each device but a byte of a device which is ready goes
+ * before the bytes of a device still busy: the program cycles of the two
+ * devices overlap.
+ *
+ */
+class Storage {
+ public:
+  uint8_t read(int idx) {
+    if (nbPending != 0) {
+      int value = -1;
+      TDB_ATOMIC {
+        value = pendingValue(idx);
+#if TDB_READY_ISR
+        // the interrupt can't write between the queue and the memory, nor
+        // during the read (EEAR)
+        if (value < 0 && idx < DEVICE2) value = EEPROM.read(idx);
+#endif
+      }
+      if (value >= 0) return value;
+    }
+    return readRaw(idx);
+  }
+
+  void write(int idx, uint8_t val) {
+    if (TDB_ROW_CACHE > 0) ROW_CACHE.invalidate(idx);
+
+    if (!async) {
+      writeRaw(idx, val);
+      return;
+    }
+
+    TDB_ATOMIC {
+      // queue full: the oldest byte is written now
+      if (nbPending == TDB_WRITE_QUEUE) writeNext();
+
+      uint8_t last      = (head + nbPending) % TDB_WRITE_QUEUE;
+      queue[last].addr  = idx;
+      queue[last].value = val;
+      nbPending += 1;
+      readyInterrupt(true);
+    }
+  }
+
+  void update(int idx, uint8_t val) {
+    if (read(idx) != val) write(idx, val);
+  }
+
+  /**
+   * @brief Read len bytes one after the other in one access: eeprom_read_block
+   * on AVR, a single sequential read on a memory behind a bus
+   *
+   * @param idx Address of the first byte
+   * @param buf Where to copy the bytes read
+   * @param len Amount of bytes
+   */
+  void readBlock(int idx, uint8_t* buf, uint8_t len) {
+#if TDB_READY_ISR
+    // the interrupt writes only the internal EEPROM: it can't write a byte of
+    // the queue between the memory and the queue, nor during the read (EEAR)
+    if (idx < DEVICE2 && nbPending != 0) {
+      TDB_ATOMIC {
+        readBlockRaw(idx, buf, len);
+        overlayPending(idx, buf, len);
+      }
+      return;
+    }
+#endif
+    if (idx >= DEVICE2 && second == nullptr) {
+      memset(buf, 0xFF, len);  // like readSecond: an erased memory
+    } else if (idx >= DEVICE2) {
+      second->readBlock(idx - DEVICE2, buf, len);
+    } else {
+      readBlockRaw(idx, buf, len);
+    }
+    if (nbPending == 0) return;
+
+    TDB_ATOMIC { overlayPending(idx, buf, len); }
+  }
+
+  /**
+   * @brief The second device, where the addresses from DEVICE2 are
+   *
+   * @param device nullptr if there is none
+   */
+  void setDevice(StorageDevice* device) {
+    sync();
+    second = device;
+  }
+
+  StorageDevice* device() { return second; }
+
+  template <typename T>
+  T& get(int idx, T& t) {
+    uint8_t* ptr = (uint8_t*)&t;
+    for (size_t i = 0; i < sizeof(T); i++) ptr[i] = read(idx + i);
+    return t;
+  }
+
+  template <typename T>
+  const T& put(int idx, const T& t) {
+    const uint8_t* ptr = (const uint8_t*)&t;
+    for (size_t i = 0; i < sizeof(T); i++) update(idx + i, ptr[i]);
+    return t;
+  }
+
+  /**
+   * @brief Enable or disable the asynchronous mode. Disabling it writes the
+   * queue first
+   *
+   * @param enable
+   */
+  void setAsync(bool enable) {
+    if (!enable) sync();
+    async = enable;
+  }
+
+  /**
+   * @brief Write the next byte of the queue of each device which is ready,
+   * without waiting
+   *
+   * @return bool True if bytes are still waiting
+   */
+  bool poll() {
+    TDB_ATOMIC {
+      for (uint8_t n = 0; n < 2 && nbPending != 0; n++) {
+        int i = readyIndex(false);
+        if (i < 0) break;
+        writeAt(i);
+      }
+    }
+    return nbPending != 0;
+  }
+
+  /**
+   * @brief Wait until all bytes of the queue are written
+   *
+   */
+  void sync() {
+    while (nbPending != 0) {
+      TDB_ATOMIC {
+        if (nbPending != 0) writeNext();
+      }
+    }
+  }
+
+  /**
+   * @brief Amount of bytes waiting to be written
+   *
+   * @return uint8_t
+   */
+  uint8_t pending() { return nbPending; }
+
+  /**
+   * @brief Called by the EEPROM ready interrupt (TDB_EE_READY_ISR): only the
+   * bytes of the internal EEPROM are written there, those of the second
+   * device by poll
+   *
+   */
+  void onReady() {
+    int i = readyIndex(true);
+    if (i >= 0)
+      writeAt(i);
+    else
+      readyInterrupt(false);
+  }
+
+ private:
+  struct PendingWrite {
+    int16_t addr;
+    uint8_t value;
+  };
+
+  uint8_t readRaw(int idx) { return idx < DEVICE2 ? EEPROM.read(idx) : readSecond(idx); }
+
+  void writeRaw(int idx, uint8_t val) {
+    if (idx < DEVICE2)
+      EEPROM.write(idx, val);
+    else
+      writeSecond(idx, val);
+  }
+
+  // out of the class: the calls of the device don't grow the inlined read / write
+  uint8_t readSecond(int idx);
+  void    writeSecond(int idx, uint8_t val);
+
+  void readBlockRaw(int idx, uint8_t* buf, uint8_t len) {
+#if defined(TINY_DATABASE_HOST)
+    EEPROM.readBlock(idx, buf, len);
+#elif defined(__AVR__)
+    eeprom_read_block(buf, (const void*)idx, len);
+#else
+    for (uint8_t i = 0; i < len; i++) buf[i] = EEPROM.read(idx + i);
+#endif
+  }
+
+  // bytes still in the queue over those read, from the oldest to the last write
+  void overlayPending(int idx, uint8_t* buf, uint8_t len) {
+    for (uint8_t i = 0; i < nbPending; i++) {
+      const PendingWrite& w = queue[(head + i) % TDB_WRITE_QUEUE];
+      if (w.addr >= idx && w.addr < idx + len) buf[w.addr - idx] = w.value;
+    }
+  }
+
+  /**
+   * @brief Value of the last write of an address still in the queue
+   *
+   * @return int -1 if the address isn't in the queue
+   */
+  int pendingValue(int idx) {
+    for (uint8_t i = nbPending; i > 0; i--) {
+      const PendingWrite& w = queue[(head + i - 1) % TDB_WRITE_QUEUE];
+      if (w.addr == idx) return w.value;
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Position in the queue of the oldest byte of a device which is
+   * ready. The bytes before it are of a device still busy
+   *
+   * @param internal Only the bytes of the internal EEPROM
+   * @return int -1 if no device with bytes is ready
+   */
+  int readyIndex(bool internal) {
+    if (second == nullptr) return (nbPending != 0 && isReady()) ? 0 : -1;
+
+    bool internalReady = isReady();
+    bool secondReady   = !internal && second->ready();
+    for (uint8_t i = 0; i < nbPending; i++) {
+      bool onSecond = queue[(head + i) % TDB_WRITE_QUEUE].addr >= DEVICE2;
+      if (onSecond ? secondReady : internalReady) return i;
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Write a byte of the queue and remove it: the bytes before it move
+   * one place
+   *
+   * @param i Position in the queue
+   */
+  void writeAt(uint8_t i) {
+    PendingWrite w = queue[(head + i) % TDB_WRITE_QUEUE];
+    for (; i > 0; i--) {
+      queue[(head + i) % TDB_WRITE_QUEUE] = queue[(head + i - 1) % TDB_WRITE_QUEUE];
+    }
+    head = (head + 1) % TDB_WRITE_QUEUE;
+    nbPending -= 1;
+    writeRaw(w.addr, w.value);
+  }
+
+  // the oldest byte of a device which is ready, else the oldest byte
+  void writeNext() {
+    int i = readyIndex(false);
+    writeAt(i < 0 ? 0 : i);
+  }
+
+  static bool isReady() {
+#if defined(TINY_DATABASE_HOST)
+    return EEPROM.ready();
+#elif defined(__AVR__)
+    return eeprom_is_ready();
+#else
+    return true;
+#endif
+  }
+
+  static void readyInterrupt(bool enable) {
+#if TDB_READY_ISR
+    if (enable)
+      EECR |= (1 << EERIE);
+    else
+      EECR &= ~(1 << EERIE);
+#else
+    (void)enable;
+#endif
+  }
+
+  PendingWrite     queue[TDB_WRITE_QUEUE];
+  uint8_t          head      = 0;        // oldest byte of the queue
+#if TDB_CONCURRENT
+  std::atomic<uint8_t> nbPending{0};  // bytes in the queue, read without the lock to skip it
+#else
+  volatile uint8_t nbPending = 0;        // bytes in the queue
+#endif
+  bool             async     = false;
+  StorageDevice*   second    = nullptr;  // the second device - see DEVICE2
+};
+
+uint8_t Storage::readSecond(int idx) {
+  return second != nullptr ? second->read(idx - DEVICE2) : 0xFF;
+}
+
+void Storage::writeSecond(int idx, uint8_t val) {
+  if (second != nullptr) second->write(idx - DEVICE2, val);
+}
+
+static Storage STORAGE;
+
+#if TDB_READY_ISR
+ISR(EE_READY_vect) { STORAGE.onReady(); }
+#endif
+
+#if TDB_CONCURRENT
+/********************************************************************************************************************************/
+/**
+ * @brief Lock of the writers and version of the data base (TDB_CONCURRENT),
+ * like a seqlock: a writer takes the lock, the version becomes odd during its
+ * writes and even again when it is done. A reader never waits: it keeps the
+ * version at the beginning of its statement and its data are valid if the
+ * version is still the same even number at the end.
+ *
+ * The lock is taken again by the task which has it (the rollup of an INSERT,
+ * the tables of an IMPORT): only the first lock and the last unlock change the
+ * version.
+ *
+ */
+class WriterLock {
+ public:
+  /**
+   * @brief Take the lock, wait for the writer of another task
+   *
+   * @return uint16_t Version of the data base before the lock (even)
+   */
+  uint16_t lock() {
+    if (owned()) {
+      depth += 1;
+      return version.load(std::memory_order_relaxed) - 1;
+    }
+
+    mutex.lock();
+    return acquired();
+  }
+
+  /**
+   * @brief Take the lock only if no other task has it
+   *
+   * @return bool True if taken: unlock it
+   */
+  bool tryLock() {
+    if (owned()) {
+      depth += 1;
+      return true;
+    }
+
+    if (!mutex.try_lock()) return false;
+    acquired();
+    return true;
+  }
+
+  /**
+   * @brief Give the lock back
+   *
+   * @param wrote False if nothing was written since lock: the version goes
+   * back to the one before, the reads of the other tasks stay valid
+   */
+  void unlock(bool wrote = true) {
+    if (--depth != 0) return;
+
+    // the bytes written are seen before the even version
+    uint16_t v = version.load(std::memory_order_relaxed);
+    version.store(wrote ? v + 1 : v - 1, std::memory_order_release);
+    owner.store(std::thread::id(), std::memory_order_relaxed);
+    mutex.unlock();
+  }
+
+  bool owned() const { return owner.load(std::memory_order_relaxed) == std::this_thread::get_id(); }
+
+  /**
+   * @brief Version at the beginning of the reads of a statement
+   *
+   */
+  uint16_t readBegin() const { return version.load(std::memory_order_acquire); }
+
+  /**
+   * @brief True if no writer ran since readBegin gave v: the data read are
+   * not torn
+   *
+   */
+  bool readValid(uint16_t v) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (v & 1) == 0 && version.load(std::memory_order_relaxed) == v;
+  }
+
+ private:
+  uint16_t acquired() {
+    owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    depth = 1;
+
+    uint16_t v = version.load(std::memory_order_relaxed);
+    version.store(v + 1, std::memory_order_relaxed);
+    // the odd version is seen before any byte written
+    std::atomic_thread_fence(std::memory_order_release);
+    return v;
+  }
+
+  std::mutex                   mutex;
+  std::atomic<std::thread::id> owner{std::thread::id()};
+  std::atomic<uint16_t>        version{0};
+  uint8_t                      depth = 0;  // locks taken by the owner
+};
+
+static WriterLock WRITER_LOCK;
+
+/**
+ * @brief Lock of the writers for the scope of a MemoryManager method which
+ * writes (CREATE_TABLE, IMPORT,...)
+ *
+ */
+struct WriterSection {
+  WriterSection() { WRITER_LOCK.lock(); }
+  ~WriterSection() { WRITER_LOCK.unlock(); }
+};
+
+#define TDB_WRITER WriterSection tdbWriter
+#else
+#define TDB_WRITER
+#endif
+
+/********************************************************************************************************************************/
+/**
+ * @brief Write frames of an image on a stream. The crc is computed on the fly
+ * so nothing is buffered: bytes can come directly from the EEPROM.
+ *
+ */
+class ImageWriter {
+ public:
+  ImageWriter(Stream& s) : out(s) {}
+
+  /**
+   * @brief First frame of an image
+   */
+  void beginImage() {
+    begin(FRAME_BEGIN, 4);
+    put('T');
+    put('D');
+    put('B');
+    put(FRAME_VERSION);
+    end();
+  }
+
+  /**
+   * @brief Last frame of an image
+   *
+   * @param nbTables Amount of tables in the image
+   * @param nbRows Amount of rows in the image
+   */
+  void endImage(uint8_t nbTables, int nbRows) {
+    begin(FRAME_END, 3);
+    put(nbTables);
+    put(nbRows & 0xFF);
+    put(nbRows >> 8);
+    end();
+  }
+
+  void begin(uint8_t type, uint8_t len) {
+    crc = 0xFFFF;
+    put(type);
+    put(len);
+  }
+
+  void put(uint8_t data) {
+    crc = crc16(crc, data);
+    out.write(data);
+  }
+
+  void end() {
+    out.write((uint8_t)(crc & 0xFF));
+    out.write((uint8_t)(crc >> 8));
+  }
+
+ private:
+  Stream&  out;
+  uint16_t crc = 0xFFFF;
+};
+
+/********************************************************************************************************************************/
+/**
+   @brief This structure represent a column of a table that user
+  instanciate to create a column
+*/
+struct Column {
+  char  name[3];
+  char* type;
+};
+
+/**
+ * @brief Will be used by an instance of TableData
+ * to hold easily column informations
+ *
+ */
+struct AllColumn {
+  char    name[3];
+  uint8_t type;
+  uint8_t flags;  // options - see COL_*
+};
+
+/*
+struct ArrayOfChar {
+  char* value;
+};
+*/
+
+class TableData;
+
+/**
+ * @brief Function called by JOIN for each pair of rows which match. Use nth
+ * with SELECT on each table to get the data of the pair
+ *
+ * @param left Table on which JOIN is called
+ * @param nthLeft Position of the row in the left table
+ * @param right Table given to JOIN
+ * @param nthRight Position of the row in the right table
+ */
+typedef void (*JoinCallback)(TableData& left, uint8_t nthLeft, TableData& right, uint8_t nthRight);
+
+/********************************************************************************************************************************/
+/**
+ * @brief TableData is the second most important class of this library.
+ * It is used to work on a table: read a table data, display them
+ * and delete operations. The main class MemoryManager has an instance of
+ * this to work on the data base (TO / FROM) and gives others with OPEN: a
+ * table kept open all the time (a log, a config,...) doesn't need to be
+ * searched again.
+ *
+ * A TableData doesn't use heap: its columns are kept in an array and the data
+ * on which we work (WHERE, GET) in a bitmap of one bit per row. Only ORDER_BY
+ * and TOP_K allocate the order of the data, until DONE.
+ *
+ * We use inline methods for function definitions to kep all code in one file.
+ *
+ */
+class TableData {
+  friend class MemoryManager;
+
+  template <typename T>
+  friend class PreparedQuery;
+
+ public:
+  TableData() {}
+
+  /**
+   * @brief Copy a table: each copy has its own columns and index
+   *
+   * @param other
+   */
+  TableData(const TableData& other) { *this = other; }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Construct a new Table Data object
+   * We work on a table after getting its information's address
+   * from Meta data parts. When we go to the Meta data parts
+   * we can have all global informations about a table: size, capacity
+   * where we start store its data in memory, columns name,...
+   *
+   *
+   * @param c_addr Where the current table data informations storage started
+   */
+  TableData(int c_addr) {
+    if (c_addr >= 0) {
+      addr      = c_addr;
+      int _addr = addr;
+
+      name[0] = char(STORAGE.read(_addr - 0));
+      name[1] = char(STORAGE.read(_addr - 1));
+      name[2] = '\0';  // char(STORAGE.read(szMeta - 2));
+
+      int16_t t_start = 0;
+      STORAGE.get(_addr - 3, t_start);
+      start = t_start;
+
+      options = tableFlags(STORAGE.read(_addr - 4));
+      size    = STORAGE.read(_addr - 5);
+
+      capacity = STORAGE.read(_addr - 6);
+
+      modSize = size % capacity;
+
+      currentAction = ACTION_SELECT;
+#if TDB_CONCURRENT
+      // another task can write before the first statement: its first
+      // operation reads the size again (under the lock if it writes)
+      synced = false;
+#else
+      synced = true;
+#endif
+
+      nbCols = STORAGE.read(_addr - 7);
+      if (nbCols > MAX_COLS) {
+        // created with a bigger TDB_MAX_COLS: we can't hold its columns
+        addr = STATUS_MAX_COLS_EXCEEDED;
+        return;
+      }
+
+      _addr -= 8;
+
+      for (size_t i = 0; i < nbCols; i++) {
+        cols[i].name[0] = char(STORAGE.read(_addr - 0));
+        cols[i].name[1] = char(STORAGE.read(_addr - 1));
+        cols[i].name[2] = '\0';  // char(STORAGE.read(szMeta - 2));
+
+        cols[i].flags = STORAGE.read(_addr - 2);
+        cols[i].type  = STORAGE.read(_addr - 3);
+        if (cols[i].flags & COL_PK) pkCol = i;
+        if (!(options & TABLE_STRIPED)) cols[i].flags &= ~COL_DEVICE2;
+
+        _addr -= 4;
+      }
+
+      if (options & TABLE_STRIPED) {
+        int16_t t_start2 = 0;
+        STORAGE.get(stripeAddr(), t_start2);
+        start2 = t_start2;
+      }
+
+      // the size of an append log is found from its rows
+      if (options & TABLE_LOG) refreshSize();
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief We use chaining syntax (operations) with TableData to
+   * manipulate its data. And we copy to the TableData instance in MemoryManager
+   * all informations when we locate a table on what to work. So
+   * we need copy assignment operator.
+   *
+   * @param other
+   * @return TableData&
+   */
+  TableData& operator=(const TableData& other) {
+    if (this == &other) return *this;
+
+    // free the order of the previous table we worked on
+    free(order);
+    order = nullptr;
+    free(staged);
+    staged = nullptr;
+    unlockWriters();
+
+    addr = other.addr;
+    strcpy(name, other.name);
+    capacity = other.capacity;
+    size     = other.size;
+    modSize  = other.modSize;
+    start    = other.start;
+    start2   = other.start2;
+    nbCols   = other.nbCols;
+
+    currentAction = other.currentAction;
+    synced        = other.synced;
+    pkCol         = other.pkCol;
+    options       = other.options;
+    lap           = other.lap;
+    rowToInsert   = other.rowToInsert;
+    rejected      = other.rejected;
+#if TDB_CONCURRENT
+    version = other.version;
+#endif
+    memcpy(sel, other.sel, SEL_SIZE);
+    nbSel      = other.nbSel;
+    filtered   = other.filtered;
+    nbOrder    = other.nbOrder;
+    cursorRank = 0;
+    cursorSlot = 0;
+    if (other.order != nullptr) {
+      order = (uint8_t*)malloc(nbOrder + 1);
+      if (order != nullptr) {
+        memcpy(order, other.order, nbOrder);
+      } else {
+        // no SRAM for the copy of the order: no data to work on
+        selectNone();
+      }
+    }
+    if (other.staged != nullptr) {
+      staged = (uint8_t*)malloc(other.stageOffset(other.nbCols));
+      if (staged != nullptr) {
+        memcpy(staged, other.staged, other.stageOffset(other.nbCols));
+      } else {
+        rejected = true;  // the new row is lost: DONE returns false
+      }
+    }
+
+    for (size_t i = 0; i < nbCols; i++) {
+      strcpy(cols[i].name, other.cols[i].name);
+      cols[i].type  = other.cols[i].type;
+      cols[i].flags = other.cols[i].flags;
+    }
+
+    return *this;
+  }
+
+  ~TableData() {
+    free(order);
+    order = nullptr;
+    free(staged);
+    staged = nullptr;
+    unlockWriters();
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Count amount of data available (like real size) in the table if
+   * WHERE is applied or not
+   *
+   * @return uint8_t
+   */
+  uint8_t COUNT() {
+    if (addr < 0) return 0;
+
+    sync();
+    return amountElt();
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Return the capacity or the maximum amount of data that the table can
+   * hold
+   *
+   * @return uint8_t
+   */
+  uint8_t CAPACITY() { return capacity; }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief This function is used to insert a new data at the end of
+   * the table. If the capacity of data of the table is reached, we
+   * re-write from the beginning of the table news data. Also we
+   * use modulo function between table size and its capacity to be
+   * sure that at any time we don't write outside of the table bound.
+   *
+   * In a table with a primary key or TABLE_ROLLUP, a new row is kept in SRAM
+   * and written by DONE: DONE returns false and writes nothing if the key
+   * isn't given or is already in the table (UPSERT updates the row of the
+   * key). The oldest rows are folded only when the row is written.
+   *
+   * @tparam T
+   * @param c_name Column name
+   * @param data Data use want to store - not a char
+   * @return TableData& The current table instance
+   */
+  template <typename T>
+  TableData& INSERT(char* c_name, const T* data) {
+    if (addr < 0) return *this;
+
+    if (!sync(true) || rejected) return *this;
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      // PRINT(c_name, pos);
+      uint8_t type = cols[pos].type;
+
+      // the key of a row found by UPSERT doesn't change
+      if (pos == pkCol && rowToInsert >= 0) return *this;
+
+      if (stages()) {
+        uint8_t* cell = stageCell(pos);
+        if (cell != nullptr && !isCharArray(type)) putCell(type, *data, cell);
+      } else {
+        int row         = rowToInsert >= 0 ? rowToInsert : modSize;
+        int addrToWrite = jumpToColumn(pos, row);
+        if (!isCharArray(type)) {
+          putValue(addrToWrite, type, *data);
+        }
+        if (rowToInsert >= 0) summarize(pos, row, false);  // a new row: at DONE
+      }
+
+      if (!rejected) currentAction = rowToInsert >= 0 ? ACTION_UPDATE : ACTION_INSERT;
+    }
+    return *this;
+  }
+
+#if TDB_WITH_CHAR
+  /********************************************************************************************************************************/
+  /**
+   * @brief An overload version othe insert template function used for char
+   * array
+   *
+   * @param c_name Column name
+   * @param data Char sequence we want to store
+   * @return TableData& The current table sequence
+   */
+  TableData& INSERT(char* c_name, char* data) {
+    if (addr < 0) return *this;
+
+    if (!sync(true) || rejected) return *this;
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      // PRINT(c_name, pos);
+      uint8_t type = cols[pos].type;
+
+      if (stages()) {
+        // the text itself: a DICT code is found (or added) by DONE
+        uint8_t* cell = stageCell(pos);
+        if (cell != nullptr && (isCharArray(type) || isDict(type))) {
+          strncpy((char*)cell, data, stageWidth(pos) - 1);
+        }
+      } else {
+        int row         = rowToInsert >= 0 ? rowToInsert : modSize;
+        int addrToWrite = jumpToColumn(pos, row);
+        if (isCharArray(type)) {
+          uint8_t nbBytes = deduceSizeof(type);
+          writeCharArray(addrToWrite, nbBytes, data);
+        } else if (isDict(type)) {
+          STORAGE.write(addrToWrite, dictCode(pos, data, true));
+        }
+      }
+
+      if (!rejected) currentAction = rowToInsert >= 0 ? ACTION_UPDATE : ACTION_INSERT;
+    }
+    return *this;
+  }
+#else
+  TableData& INSERT(char* c_name, char* data) = delete;
+#endif
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief An updata function is just an override methods over a data at
+   * a position in the table. The amount of data doesn't increase or decrease,
+   * just an override. - not char array
+   *
+   * The primary key of another row is not written: DONE returns false.
+   *
+   * @tparam T
+   * @param c_name Column name
+   * @param data Data to override
+   * @param nth Position where to override
+   * @return TableData& The current table sequence
+   */
+  template <typename T>
+  TableData& UPDATE(char* c_name, const T* data, int nth) {
+    if (addr < 0) return *this;
+
+    if (!sync(true)) return *this;
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      // PRINT(c_name, pos);
+      uint8_t type = cols[pos].type;
+
+      int index       = indexMatch(nth);
+      int addrToWrite = jumpToColumn(pos, index);
+
+      if (pos == pkCol) {
+        if (keyTaken((const uint8_t*)data, sizeof(T), index)) return *this;
+        removeKey(index);
+      }
+      if (!isCharArray(type)) {
+        putValue(addrToWrite, type, *data);
+      }
+      if (pos == pkCol) addKey(index);
+      summarize(pos, index, false);
+
+      currentAction = ACTION_UPDATE;
+    }
+    return *this;
+  }
+
+#if TDB_WITH_CHAR
+  /********************************************************************************************************************************/
+  /**
+   * @brief Used for char array
+   *
+   * @param c_name Column name
+   * @param data Data to override
+   * @param nth Position to update
+   * @return TableData& The current table sequence
+   */
+  TableData& UPDATE(char* c_name, char* data, int nth) {
+    if (addr < 0) return *this;
+
+    if (!sync(true)) return *this;
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      // PRINT(c_name, pos);
+      uint8_t type = cols[pos].type;
+
+      int index       = indexMatch(nth);
+      int addrToWrite = jumpToColumn(pos, index);
+
+      if (isCharArray(type)) {
+        uint8_t nbBytes = deduceSizeof(type);
+        writeCharArray(addrToWrite, nbBytes, data);
+      } else if (isDict(type)) {
+        STORAGE.update(addrToWrite, dictCode(pos, data, true));
+      }
+
+      currentAction = ACTION_UPDATE;
+    }
+
+    return *this;
+  }
+#else
+  TableData& UPDATE(char* c_name, char* data, int nth) = delete;
+#endif
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Give the same value to a column in all rows on which we work (all
+   * the table or those which match the FILTER if WHERE is applied), in one
+   * pass. Only the bytes which change are written:
+   *
+   * mem.TO("EM").WHERE("ag", isGreaterThan, &age).UPDATE_ALL("st", &off).DONE();
+   *
+   * Refused like SET on the primary key and on CHAR and DICT columns (give them
+   * a char*): DONE returns false
+   *
+   * @tparam T Type of the column data - its size must be the one of the column
+   * @param c_name Column name
+   * @param data New value
+   * @return TableData& The current table sequence
+   */
+  template <typename T>
+  TableData& UPDATE_ALL(char* c_name, const T* data) {
+    return SET(c_name, OPERATION::setTo, data);
+  }
+
+#if TDB_WITH_CHAR
+  /********************************************************************************************************************************/
+  /**
+   * @brief Used for char array
+   *
+   * @param c_name Column name
+   * @param data New value
+   * @return TableData& The current table sequence
+   */
+  TableData& UPDATE_ALL(char* c_name, char* data) {
+    if (addr < 0) return *this;
+
+    if (!sync(true)) return *this;
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND && isDict(cols[pos].type)) {
+      // the value is added once, then only its code is written
+      int     addrCol = jumpToColumn(pos, 0);
+      int     step    = stepOf(pos);
+      uint8_t amount  = amountElt();
+      uint8_t code    = dictCode(pos, data, true);
+
+      for (size_t i = 0; i < amount; i++) {
+        STORAGE.update(addrCol + slotAt(i) * step, code);
+      }
+
+      currentAction = ACTION_UPDATE;
+    } else if (pos != STATUS_COL_NOT_FOUND && isCharArray(cols[pos].type)) {
+      uint8_t nbBytes = deduceSizeof(cols[pos].type);
+      int     addrCol = jumpToColumn(pos, 0);
+      int     step    = stepOf(pos);
+      uint8_t amount  = amountElt();
+      uint8_t len     = strlen(data) > nbBytes ? nbBytes : strlen(data);
+
+      for (size_t i = 0; i < amount; i++) {
+        int from = addrCol + slotAt(i) * step;
+        for (size_t k = 0; k < len; k++) {
+          STORAGE.update(from + k, data[k]);
+        }
+        if (len < nbBytes) STORAGE.update(from + len, '\0');
+      }
+
+      currentAction = ACTION_UPDATE;
+    }
+
+    return *this;
+  }
+#else
+  TableData& UPDATE_ALL(char* c_name, char* data) = delete;
+#endif
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Compute the new value of a column from its current value in all
+   * rows on which we work, in one pass: SET("ag", increaseBy, &one) is
+   * "SET ag = ag + 1". Only the bytes which change are written. Refused
+   * (DONE returns false) on the primary key, which would get the same value in
+   * many rows, on CHAR and DICT columns (a code isn't a number), and with a T
+   * of another size than the column or which isn't a float for FLOAT16 and
+   * FIXED16
+   *
+   * @tparam T Type of the column data - its size must be the one of the column,
+   * except for FLOAT16 and FIXED16 (float)
+   * @param c_name Column name
+   * @param op The operation - enum value
+   * @param operand Second operand of the operation
+   * @return TableData& The current table sequence
+   */
+  template <typename T>
+  TableData& SET(char* c_name, OPERATION op, const T* operand) {
+    if (addr < 0) return *this;
+
+    if (!sync(true)) return *this;
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      uint8_t                      type    = cols[pos].type;
+      uint8_t                      nbBytes = deduceSizeof(type);
+      typename Operation<T>::Apply apply   = Operation<T>::of(op);
+
+      bool number = !isCharArray(type) && !isDict(type);
+      bool sized  = isQuantized(type) ? IsFloat<T>::value : sizeof(T) == nbBytes;
+      if (pos == pkCol || !number || !sized) {
+        rejected = true;
+      } else if (apply != nullptr) {
+        int     addrCol = jumpToColumn(pos, 0);
+        int     step    = stepOf(pos);
+        uint8_t amount  = amountElt();
+        bool    changed = false;
+
+        for (size_t i = 0; i < amount; i++) {
+          int from = addrCol + slotAt(i) * step;
+
+          // the old value is known: we compare without reading again
+          if (isQuantized(type)) {
+            uint16_t raw = 0;
+            STORAGE.get(from, raw);
+            uint16_t result = quantize(type, (float)apply((T)dequantize(type, raw), *operand));
+            changed |= writeChanged(from, (uint8_t*)&raw, (uint8_t*)&result, nbBytes);
+          } else {
+            T data = 0;
+            STORAGE.get(from, data);
+            T result = apply(data, *operand);
+            changed |= writeChanged(from, (uint8_t*)&data, (uint8_t*)&result, nbBytes);
+          }
+        }
+
+        if (changed) rebuildSummaries();
+
+        currentAction = ACTION_UPDATE;
+      }
+    }
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Retrieve a data from the table memory. Based on the data
+   * type we can retrieve the exact data at position. It returns one
+   * data per time - not char array
+   *
+   * @tparam T
+   * @param c_name Column name
+   * @param data Data to hold value
+   * @param nth Position where to get value
+   * @return TableData& The current table sequence
+   */
+  template <typename T>
+  TableData& SELECT(char* c_name, T* data, int nth = 0) {
+    if (addr < 0) return *this;
+
+    sync();
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      // PRINT(c_name, pos);
+
+      uint8_t amount = amountElt();
+      if (amount != 0) {
+        int index = indexMatch(nth);
+
+        uint8_t type = cols[pos].type;
+        if (isQuantized(type)) {
+          uint16_t raw = 0;
+          readCell(pos, index, (uint8_t*)&raw, sizeof(raw));
+          *data = (T)dequantize(type, raw);
+        } else if (!isCharArray(type)) {
+          readCell(pos, index, (uint8_t*)data, sizeof(T));
+        }
+
+        currentAction = ACTION_SELECT;
+      }
+    } else {
+      data = NULL;
+    }
+    return *this;
+  }
+
+#if TDB_WITH_CHAR
+  /********************************************************************************************************************************/
+  /**
+   * @brief For char array
+   *
+   * @param c_name Column name
+   * @param data char array to get value
+   * @param nth Position where to get value
+   * @return TableData& The current table sequence
+   */
+  TableData& SELECT(char* c_name, char* data, int nth = 0) {
+    if (addr < 0) return *this;
+
+    sync();
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      // PRINT(c_name, pos);
+
+      uint8_t amount = amountElt();
+      if (amount != 0) {
+        int index      = indexMatch(nth);
+        int addrToRead = jumpToColumn(pos, index);
+
+        uint8_t type = cols[pos].type;
+        if (isCharArray(type)) {
+          uint8_t nbBytes = deduceSizeof(type);
+          readCharArray(addrToRead, nbBytes, data);
+        } else if (isDict(type)) {
+          uint8_t code = DICT_NONE;
+          readCell(pos, index, &code, 1);
+          readDictValue(pos, code, data);
+        }
+
+        currentAction = ACTION_SELECT;
+      }
+    } else {
+      data = NULL;
+    }
+    return *this;
+  }
+#else
+  TableData& SELECT(char* c_name, char* data, int nth = 0) = delete;
+#endif
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Retireve all data possible from the table. If WHERE methods
+   * is used, it returns only data that match the FILTER
+   *
+   * @tparam T
+   * @param c_name Column name
+   * @param data Array to hold data selected
+   * @param nbData amount of data finds. Zero if no data is found or match.
+   * @return TableData& The current table sequence
+   */
+  template <typename T>
+  TableData& SELECT_ALL(char* c_name, T* data, int& nbData) {
+    if (addr < 0) return *this;
+
+    sync();
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      selectAll(pos, data, nbData);
+    } else {
+      data = NULL;
+    }
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief One value from the data on which we work of a numeric column: their
+   * sum, the smallest, the highest or their average. It is computed as T, so
+   * give a float for the average of integers. The column is read by blocks
+   * when the data are in the order of the table
+   *
+   * mem.FROM("TP").WHERE("hr", isGreaterOrEqualTo, &from).AGGREGATE("tp", averageOf, &avg).DONE();
+   *
+   * @tparam T
+   * @param c_name Column name - numerics only
+   * @param a An aggregation - enum value
+   * @param result Its value. Not changed if there is no data
+   * @return TableData& The current table sequence
+   */
+  template <typename T>
+  TableData& AGGREGATE(char* c_name, AGGREGATION a, T* result) {
+    if (addr < 0) return *this;
+
+    sync();
+    int pos = isColumnExist(c_name);
+    if (pos == STATUS_COL_NOT_FOUND) return *this;
+
+    uint8_t type = cols[pos].type;
+    if (type >= 9 && !isQuantized(type)) return *this;
+
+    T       value  = 0;
+    uint8_t amount = 0;
+    auto    add    = [&](const uint8_t* cell) {
+      T data = cellAs<T>(type, cell);
+      if (amount == 0 || a == sumOf || a == averageOf) {
+        value = (amount == 0) ? data : value + data;
+      } else if ((a == minOf && data < value) || (a == maxOf && data > value)) {
+        value = data;
+      }
+      amount += 1;
+    };
+
+    if (order != nullptr) {
+      int     addrCol = jumpToColumn(pos, 0);
+      int     step    = stepOf(pos);
+      uint8_t nbBytes = deduceSizeof(type);
+      uint8_t cell[4];
+      for (size_t i = 0; i < nbOrder; i++) {
+        STORAGE.readBlock(addrCol + order[i] * step, cell, nbBytes);
+        add(cell);
+      }
+    } else {
+      scanColumn(pos, [&](uint8_t, const uint8_t* cell) { add(cell); });
+    }
+
+    if (amount != 0) *result = (a == averageOf) ? value / amount : value;
+    currentAction = ACTION_SELECT;
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+
+  /**
+   * @brief For char array - Next update of library
+   *
+   */
+  //    TableData& SELECT_ALL(char* c_name, ArrayOfChar* data, int& nbData) {
+  //      int pos = isColumnExist(c_name);
+  //      if (pos != STATUS_COL_NOT_FOUND) {
+  //
+  //        uint8_t amount = amountElt();
+  //        nbData = amount;
+  //        if ( amount != 0 ) {
+  //          uint8_t type = cols[pos].type;
+  //
+  //          if (type  > 9 ) {
+  //
+  //            for (size_t i = 0; i < amount; i++) {
+  //              int index = indexMatch(i);
+  //              int addrToRead = jumpToColumn(pos, index);
+  //
+  //              uint8_t nbBytes = deduceSizeof(type);
+  //              readCharArray(addrToRead, nbBytes, data[i].value);
+  //            }
+  //          }
+  //
+  //          currentAction = ACTION_SELECT;
+  //        }
+  //      }
+  //
+  //      return *this;
+  //    }
+
+#if TDB_WITH_DELETE
+  /********************************************************************************************************************************/
+
+  /**
+   * @brief We can delete a row of the table based on the position. If you apply
+   * a WHERE method before, it will delete only data at the position wanted that
+   * match the FILTER. One row per time is deleted here.
+   *
+   * @param nth
+   * @return TableData& The current table sequence
+   */
+  TableData& DELETE(int nth = 0) {
+    if (addr < 0) return *this;
+
+    if (!sync(true)) return *this;
+    uint8_t amount = amountElt();
+    if (amount != 0) {
+      uint8_t index = indexMatch(nth);
+
+      eraseRow(index);
+
+      moveAfterDelete(index);
+      sizeAfterDelete(1);
+      rebuildSummaries();
+      currentAction = ACTION_DELETE;
+
+      debugDisplayindexElt();
+    }
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Delete all data wanted (if WHERE methods is used before)
+   *
+   * @param nbData Amount of data deleted
+   * @return TableData& The current table sequence
+   */
+  TableData& DELETE_ALL(int& nbData) {
+    if (addr < 0) return *this;
+
+    if (!sync(true)) return *this;
+    uint8_t amount = amountElt();
+    nbData         = amount;
+    if (amount != 0) {
+      // rows to delete, one bit per slot
+      uint8_t deleted[SEL_SIZE] = {0};
+      for (size_t i = 0; i < amount; i++) {
+        uint8_t slot = slotAt(i);
+        deleted[slot / 8] |= 1 << (slot % 8);
+        if (pkCol >= 0) removeKey(slot);
+      }
+
+      compactRows(deleted);
+      if (pkCol >= 0) compactKeys(deleted);
+      sizeAfterDelete(amount);
+      rebuildSummaries();
+
+      // nothing remains of the rows on which we worked
+      if (filtered || order != nullptr) selectNone();
+
+      debugDisplayindexElt();
+
+      // size -= amount;
+      currentAction = ACTION_DELETE_ALL;
+    }
+
+    return *this;
+  }
+#endif
+
+#if TDB_WITH_WHERE
+  /********************************************************************************************************************************/
+
+  /**
+   * @brief It's used to filter data from the table. So user can decide to get
+   * data that match a condition- numerics data. The data of a FLOAT16 or
+   * FIXED16 column are compared as float, whatever T is
+   *
+   * @tparam T
+   * @param c_name Column name
+   * @param f A filter - enum value
+   * @param data Data that column data will be compared
+   * @return TableData&
+   */
+  template <typename T>
+  TableData& WHERE(char* c_name, FILTER f, T* data) {
+    if (addr < 0) return *this;
+
+    sync();
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      uint8_t type = cols[pos].type;
+      if (type >= 9 && !isQuantized(type)) {
+        selectNone();
+      } else {
+        keepFiltered(pos, f, *data);
+      }
+
+      currentAction = ACTION_WHERE;
+    }
+
+    return *this;
+  }
+
+#if TDB_WITH_CHAR
+  /********************************************************************************************************************************/
+  /**
+   * @brief Filter on a text column (CHARnn or DICTnn), in the order of strcmp.
+   * On a DICT column the FILTER is applied once on each value of the
+   * dictionary: then the rows are selected by their code, one byte each
+   *
+   * mem.FROM("EV").WHERE("st", isEqualTo, "ALARM").SELECT_ALL("tm", times, nb).DONE();
+   *
+   * @param c_name Column name
+   * @param f A filter - enum value
+   * @param data Text that column data will be compared
+   * @return TableData&
+   */
+  TableData& WHERE(char* c_name, FILTER f, const char* data) {
+    if (addr < 0) return *this;
+
+    sync();
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND) {
+      uint8_t type    = cols[pos].type;
+      uint8_t nbBytes = deduceSizeof(type);
+      int     addrCol = jumpToColumn(pos, 0);
+      int     step    = stepOf(pos);
+
+      typename FilterTest<int>::Test test = FilterTest<int>::of(f);
+      if (test == nullptr || !(isCharArray(type) || isDict(type))) {
+        selectNone();
+      } else if (isDict(type)) {
+        // codes which match: a row without value is compared as ""
+        uint8_t width = type - TYPE_DICT;
+        int     from  = dictAddr(pos);
+        uint8_t matches[(DICT_ENTRIES + 7) / 8] = {0};
+        for (uint8_t code = 0; code < DICT_ENTRIES; code++) {
+          int entry = from + code * width;
+          if (STORAGE.read(entry) == DICT_FREE) break;
+          if (test(compareText(entry, width, data), 0)) matches[code / 8] |= 1 << (code % 8);
+        }
+        bool noneMatch = test(data[0] == '\0' ? 0 : -1, 0);
+
+        keepMatchingCells(pos, [&](const uint8_t* cell) {
+          uint8_t code = cell[0];
+          if (code >= DICT_ENTRIES) return noneMatch;
+          return (matches[code / 8] & (1 << (code % 8))) != 0;
+        });
+      } else {
+        keepMatching([&](uint8_t slot) {
+          return test(compareText(addrCol + slot * step, nbBytes, data), 0);
+        });
+      }
+
+      currentAction = ACTION_WHERE;
+    }
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief For char array
+   *
+   * @param c_name Column name
+   * @param f A filter - enum value
+   * @param data Text that column data will be compared
+   * @return TableData&
+   */
+  TableData& WHERE(char* c_name, FILTER f, char* data) {
+    return WHERE(c_name, f, (const char*)data);
+  }
+#else
+  TableData& WHERE(char* c_name, FILTER f, const char* data) = delete;
+  TableData& WHERE(char* c_name, FILTER f, char* data)       = delete;
+#endif
+#endif
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Find a row by the value of its primary key (a column declared with
+   * "PK" at CREATE_TABLE): the index of the key is used instead of reading the
+   * whole column. The row found (or nothing) becomes the data on which we work,
+   * like after a WHERE:
+   *
+   * mem.FROM("DV").GET(&id).SELECT("st", &state).DONE();
+   *
+   * @tparam K Type of the primary key
+   * @param key Value of the primary key
+   * @return TableData& The current table sequence
+   */
+  template <typename K>
+  TableData& GET(const K* key) {
+    if (addr < 0) return *this;
+
+    sync();
+    int slot = -1;
+    if (pkCol >= 0 && sizeof(K) == deduceSizeof(cols[pkCol].type)) {
+      uint16_t bucket;
+      slot = findKey((const uint8_t*)key, bucket);
+    }
+
+    selectNone();
+    if (slot >= 0) {
+      sel[slot / 8] |= 1 << (slot % 8);
+      nbSel = 1;
+    }
+
+    currentAction = ACTION_WHERE;
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Insert a row or update it if its primary key already exists. The
+   * INSERT which follow write in this row, DONE adds it to the table only if it
+   * is a new one:
+   *
+   * mem.TO("DV").UPSERT(&id).INSERT("st", &state).DONE();
+   *
+   * @tparam K Type of the primary key
+   * @param key Value of the primary key
+   * @return TableData& The current table sequence
+   */
+  template <typename K>
+  TableData& UPSERT(const K* key) {
+    if (addr < 0 || pkCol < 0 || sizeof(K) != deduceSizeof(cols[pkCol].type)) return *this;
+
+    if (!sync(true)) return *this;
+    uint16_t bucket;
+    int      slot = findKey((const uint8_t*)key, bucket);
+    if (slot >= 0) {
+      rowToInsert   = slot;
+      currentAction = ACTION_UPDATE;
+    } else {
+      rowToInsert = -1;
+      INSERT(cols[pkCol].name, key);
+    }
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Join this table with another one on equal values of a column of
+   * each: for each pair of rows which match, cb is called. Only data available
+   * on both sides (those which match the FILTER if WHERE is applied) are joined.
+   *
+   * The column of the other table is read once and its rows are sorted in SRAM
+   * by a hash of their value (2 bytes per row), so each row of this table is
+   * matched with a binary search instead of reading again the other table
+   * (no pair and no data left to work on if the heap has no room for them).
+   * Columns must be numerics of the same type. The other table must be a
+   * TableData of its own (see MemoryManager::OPEN).
+   *
+   * @param other The other table (right)
+   * @param leftCol Column of this table
+   * @param rightCol Column of the other table
+   * @param cb Function called for each pair
+   * @return TableData& The current table sequence
+   */
+  TableData& JOIN(TableData& other, char* leftCol, char* rightCol, JoinCallback cb) {
+    if (addr < 0 || other.addr < 0) return *this;
+
+    sync();
+    other.sync();
+
+    int left  = isColumnExist(leftCol);
+    int right = other.isColumnExist(rightCol);
+    if (left == STATUS_COL_NOT_FOUND || right == STATUS_COL_NOT_FOUND) return *this;
+
+    uint8_t type = cols[left].type;
+    if ((type >= 9 && !isQuantized(type)) || type != other.cols[right].type) return *this;
+
+    uint8_t nbBytes   = deduceSizeof(type);
+    int     addrLeft  = jumpToColumn(left, 0);
+    int     addrRight = other.jumpToColumn(right, 0);
+    int     stepLeft  = stepOf(left);
+    int     stepRight = other.stepOf(right);
+    uint8_t amount    = amountElt();
+    uint8_t nbRight   = other.amountElt();
+    uint8_t key[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+    uint8_t keyRight[sizeof(key)];
+
+    currentAction = ACTION_SELECT;
+    if (amount == 0 || nbRight == 0) return *this;
+
+    // hash of each row of the other table, sorted with the position of the row
+    uint8_t* hashes = (uint8_t*)malloc(2 * nbRight);
+    if (hashes == nullptr) {
+      // no SRAM for the lookup: no pair
+      selectNone();
+      return *this;
+    }
+
+    uint8_t* rows = hashes + nbRight;
+    for (size_t k = 0; k < nbRight; k++) {
+      readKey(addrRight + other.slotAt(k) * stepRight, nbBytes, keyRight);
+      uint8_t h = keyHash(keyRight, nbBytes);
+
+      // insertion: rows with the same hash stay in their order
+      size_t j = k;
+      for (; j > 0 && hashes[j - 1] > h; j--) {
+        hashes[j] = hashes[j - 1];
+        rows[j]   = rows[j - 1];
+      }
+      hashes[j] = h;
+      rows[j]   = k;
+    }
+
+    for (size_t i = 0; i < amount; i++) {
+      readKey(addrLeft + slotAt(i) * stepLeft, nbBytes, key);
+      uint8_t h = keyHash(key, nbBytes);
+
+      // first row of the other table with this hash
+      size_t lo = 0, hi = nbRight;
+      while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (hashes[mid] < h)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+
+      for (size_t j = lo; j < nbRight && hashes[j] == h; j++) {
+        // a value of one byte is its own hash: nothing to check
+        if (nbBytes > 1) {
+          readKey(addrRight + other.slotAt(rows[j]) * stepRight, nbBytes, keyRight);
+          if (memcmp(key, keyRight, nbBytes) != 0) continue;
+        }
+        cb(*this, i, other, rows[j]);
+      }
+    }
+
+    free(hashes);
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Sort data available (those which match the FILTER if WHERE is
+   * applied before) by the value of a column. Only the index of data are
+   * sorted (in place, heap sort): SELECT / SELECT_ALL / EXPORT,... give data
+   * in this order until DONE. Values are read from the memory when they are
+   * compared, so only the index is in SRAM (no data left if the heap has no
+   * room for it) - numerics only
+   *
+   * @param c_name Column name
+   * @param o ASC or DESC
+   * @return TableData& The current table sequence
+   */
+  TableData& ORDER_BY(char* c_name, ORDER o = ASC) {
+    if (addr < 0) return *this;
+
+    sync();
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND && (cols[pos].type < 9 || isQuantized(cols[pos].type))) {
+      uint8_t type    = cols[pos].type;
+      uint8_t nbBytes = deduceSizeof(type);
+      int     addrCol = jumpToColumn(pos, 0);
+      int     step    = stepOf(pos);
+      uint8_t amount  = amountElt();
+      uint8_t a[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+      uint8_t b[sizeof(a)];
+
+      if (!keepOrder()) return *this;
+      uint8_t* index = order;
+
+      auto before = [&](size_t i, size_t j) {
+        readKey(addrCol + index[i] * step, nbBytes, a);
+        readKey(addrCol + index[j] * step, nbBytes, b);
+        return isBefore(type, a, b, o);
+      };
+      auto swap = [&](size_t i, size_t j) {
+        uint8_t tmp = index[i];
+        index[i]    = index[j];
+        index[j]    = tmp;
+      };
+      heapSort(amount, before, swap);
+
+      currentAction = ACTION_SELECT;
+    }
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Keep only the k first data (those which match the FILTER if WHERE is
+   * applied before) in the order of a column: the k highest with DESC. The
+   * column is read once and the k best data are kept in a heap in SRAM, so it
+   * costs k * (1 + sizeof) bytes (no data left if the heap has no room for
+   * them). Then data are given in this order until DONE - numerics only
+   *
+   * @param c_name Column name
+   * @param k Amount of data to keep
+   * @param o DESC (the highest) or ASC (the smallest)
+   * @return TableData& The current table sequence
+   */
+  TableData& TOP_K(char* c_name, uint8_t k, ORDER o = DESC) {
+    if (addr < 0) return *this;
+
+    sync();
+    int pos = isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND && (cols[pos].type < 9 || isQuantized(cols[pos].type))) {
+      uint8_t type    = cols[pos].type;
+      uint8_t nbBytes = deduceSizeof(type);
+      int     addrCol = jumpToColumn(pos, 0);
+      int     step    = stepOf(pos);
+      uint8_t amount  = amountElt();
+      if (k > amount) k = amount;
+
+      // heap of the k best data: the worst is at the top. One more value after
+      // the heap to read the next data
+      uint8_t* slots = (uint8_t*)malloc(k + (k + 1) * nbBytes);
+      if (slots == nullptr) {
+        // no SRAM for the heap: no data to work on
+        selectNone();
+        return *this;
+      }
+
+      uint8_t* values = slots + k;
+      uint8_t* next   = values + k * nbBytes;
+
+      auto before = [&](size_t i, size_t j) {
+        return isBefore(type, values + i * nbBytes, values + j * nbBytes, o);
+      };
+      auto swap = [&](size_t i, size_t j) {
+        uint8_t tmp = slots[i];
+        slots[i]    = slots[j];
+        slots[j]    = tmp;
+        for (size_t b = 0; b < nbBytes; b++) {
+          tmp                     = values[i * nbBytes + b];
+          values[i * nbBytes + b] = values[j * nbBytes + b];
+          values[j * nbBytes + b] = tmp;
+        }
+      };
+
+      for (uint8_t i = 0; i < amount && k > 0; i++) {
+        uint8_t slot = slotAt(i);
+        if (i < k) {
+          slots[i] = slot;
+          readKey(addrCol + slot * step, nbBytes, values + i * nbBytes);
+          if (i == k - 1) {
+            for (size_t r = k / 2; r > 0; r--) siftDown(r - 1, k, before, swap);
+          }
+        } else {
+          readKey(addrCol + slot * step, nbBytes, next);
+          if (isBefore(type, next, values, o)) {
+            // better than the worst kept: it takes its place
+            slots[0] = slot;
+            memcpy(values, next, nbBytes);
+            siftDown(0, k, before, swap);
+          }
+        }
+      }
+
+      // sorted in SRAM: already a heap, nothing is read
+      heapSort(k, before, swap);
+
+      // the slots are at the beginning of the buffer: the values are dropped
+      // (the whole buffer is kept if the heap can't shrink it)
+      uint8_t* shrunk = (uint8_t*)realloc(slots, k + 1);
+      free(order);
+      order   = shrunk != nullptr ? shrunk : slots;
+      nbOrder = k;
+
+      currentAction = ACTION_SELECT;
+    }
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Keep only the n first data on which we work (those which match the
+   * FILTER if WHERE is applied before, in the order of ORDER_BY / TOP_K). Only
+   * the selection in SRAM is changed: SELECT_ALL, AGGREGATE, EXPORT,... then
+   * read only the rows kept
+   *
+   * mem.FROM("TP").OFFSET(20).LIMIT(10).SELECT_ALL("tp", page, nb).DONE();
+   *
+   * @param n Amount of data to keep
+   * @return TableData& The current table sequence
+   */
+  TableData& LIMIT(uint8_t n) {
+    if (addr < 0) return *this;
+
+    sync();
+    keepRanks(0, n);
+
+    currentAction = ACTION_SELECT;
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Skip the k first data on which we work: give it before LIMIT. The
+   * rows skipped are not read
+   *
+   * @param k Amount of data to skip
+   * @return TableData& The current table sequence
+   */
+  TableData& OFFSET(uint8_t k) {
+    if (addr < 0) return *this;
+
+    sync();
+    keepRanks(k, amountElt());
+
+    currentAction = ACTION_SELECT;
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Keep the next page of n data on which we work. The token tells
+   * where the page starts: 0 for the first one. It is changed to where the
+   * next page starts, -1 after the last page. The token is a slot of the
+   * table (a rank with ORDER_BY / TOP_K): rows inserted between two pages
+   * don't shift the pages, and only the rows of the page are read, whatever
+   * the page
+   *
+   * int token = 0;
+   * while (token >= 0) {
+   *   mem.FROM("TP").PAGE(8, token).SELECT_ALL("tp", page, nb).DONE();
+   *   ...
+   * }
+   *
+   * @param n Amount of data of a page
+   * @param token Where the page starts, then where the next one starts
+   * @return TableData& The current table sequence
+   */
+  TableData& PAGE(uint8_t n, int& token) {
+    int at = token;
+    token  = -1;  // no table: no page after
+    if (addr < 0) return *this;
+
+    sync();
+    uint8_t amount = amountElt();
+    uint8_t used   = (size >= capacity) ? capacity : size;
+    uint8_t from   = amount;
+    if (at >= 0 && order != nullptr) {
+      from = (at < amount) ? at : amount;
+    } else if (at >= 0 && at < used) {
+      from = filtered ? countBefore(sel, at) : at;
+    }
+    keepRanks(from, n);
+
+    if (n != 0 && from + amountElt() < amount) {
+      token = (order != nullptr) ? from + n : slotAt(n - 1) + 1;
+    }
+
+    currentAction = ACTION_SELECT;
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Write a binary image of the table on a stream: only data available
+   * (those which match the FILTER if WHERE is applied before). Data are read and
+   * written directly, there is no buffer. The image can be loaded with
+   * MemoryManager::IMPORT or decoded on a computer - see extras/tools
+   *
+   * @param out Where to write the image (Serial, a file,...)
+   * @return TableData& The current table sequence
+   */
+  TableData& EXPORT(Stream& out) {
+    if (addr < 0) return *this;
+
+    sync();
+    ImageWriter w(out);
+    w.beginImage();
+    int nbRows = exportTable(w, false);
+    w.endImage(1, nbRows);
+
+    currentAction = ACTION_SELECT;
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+
+  /**
+   * @brief Each time that an operation is done on the table, some
+   * informations must be updated to keep consistent the current table data
+   * So user must be call this function all times he ue: INSERT / SELECT /
+   * SELECT_ALL / UPDATE / DELETE / DELETE_ALL
+   *
+   * False if the statement was rejected: a primary key not given or already
+   * in the table (INSERT, UPDATE) or SET of the primary key. With TDB_CONCURRENT, false
+   * too if a writer of another task ran during the statement: the data it
+   * read may be torn (or, after a WHERE, it wrote nothing), run it again.
+   *
+   * @return bool True if the statement is valid
+   */
+  bool DONE() {
+    bool done = readValid();
+    if (rejected) done = false;
+
+    // a new row kept by INSERT: written now that it is complete
+    if (currentAction == ACTION_INSERT && staged != nullptr && (!done || !writeStaged())) {
+      done          = false;
+      currentAction = ACTION_SELECT;
+    }
+
+    if (currentAction == ACTION_INSERT) {  // INSERTION
+      if (pkCol >= 0) addKey(modSize);
+      for (size_t i = 0; i < nbCols; i++) {
+        summarize(i, modSize, true);  // with the columns not given to INSERT
+      }
+      size += 1;
+
+      if (size == (2 * capacity)) {
+        size = capacity;
+        // PRINT("capacity", capacity);
+
+        // all rows were written again: the values overwritten leave the filters
+        rebuildBlooms();
+      }
+
+      if (options & TABLE_LOG) {
+        // the row gets the lap of the ring: the size is found from them, so the
+        // writes are spread on the laps instead of the same byte
+        if (modSize == 0) lap = nextLap(lap);
+        STORAGE.write(lapAddr() + modSize, lap);
+      } else {
+        STORAGE.write(addr - 5, size);  // -5
+      }
+    }
+
+    reset();
+    return done;
+  }
+
+  /********************************************************************************************************************************/
+  //// UTILITIES FUNCTIONS ////
+  /**
+   * @brief Verify if a column exist based on the name give as argument
+   *
+   * @param c_name Column name
+   * @return int A number superior to zero (as column position in the table) if
+   * column is found and inferior if not.
+   */
+  int isColumnExist(char* c_name) {
+    for (size_t i = 0; i < nbCols; i++) {
+      if (strcmp(c_name, cols[i].name) == 0) return i;
+    }
+
+    return STATUS_COL_NOT_FOUND;
+  }
+
+ private:
+  /********************************************************************************************************************************/
+  /**
+   * @brief Allow us to jump directly at a column position in the table. The
+   * data of a column are one after the other, or with TABLE_ROWS the data of
+   * a row are one after the other. With TABLE_STRIPED the columns of the
+   * second device are one after the other from start2
+   *
+   * @param indexCol Position of the column in the data base
+   * @param currentPos Index in this column where we want to operate
+   * @return int The column address in the memory
+   */
+  int jumpToColumn(size_t indexCol, int currentPos) {
+    uint8_t device = cols[indexCol].flags & COL_DEVICE2;
+    int     pos    = (device ? start2 : start) + stepOf(indexCol) * currentPos;
+    for (size_t i = 0; i < indexCol; i++) {
+      if ((cols[i].flags & COL_DEVICE2) != device) continue;
+      pos += deduceSizeof(cols[i].type) * ((options & TABLE_ROWS) ? 1 : (int)capacity);
+    }
+
+    return pos;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Bytes from the data of a column in a row to its data in the next
+   * row: the size of the column, or the size of a row with TABLE_ROWS
+   *
+   * @param indexCol Position of the column in the data base
+   * @return int
+   */
+  int stepOf(size_t indexCol) {
+    return (options & TABLE_ROWS) ? rowWidth() : deduceSizeof(cols[indexCol].type);
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief To retrieve data or delete them, we keep the slots (index in
+   * table memory) of the data on which we work. When WHERE is applied, it is a
+   * bitmap (sel): bit i is set if the row at slot i matches. ORDER_BY and TOP_K
+   * keep the slots in their order in an array (order). If nothing is applied,
+   * data are in their order (0 to capacity - 1): see slotAt
+   *
+   */
+  void initSelection() {
+    free(order);
+    order      = nullptr;
+    nbOrder    = 0;
+    filtered   = false;
+    nbSel      = 0;
+    cursorRank = 0;
+    cursorSlot = 0;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief No data to work on (after DELETE_ALL, a GET which doesn't find its
+   * key,...)
+   *
+   */
+  void selectNone() {
+    initSelection();
+    memset(sel, 0, SEL_SIZE);
+    filtered = true;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Select the used first slots: the bitmap of "nothing applied"
+   *
+   * @param used
+   */
+  void selectFirst(uint8_t used) {
+    selectNone();
+    memset(sel, 0xFF, used / 8);
+    if (used % 8 != 0) sel[used / 8] = (1 << (used % 8)) - 1;
+    nbSel = used;
+  }
+
+  bool isSelected(uint8_t slot) { return sel[slot / 8] & (1 << (slot % 8)); }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Keep only the data on which we work which match (WHERE): the bits of
+   * the others are cleared, or after ORDER_BY / TOP_K the data which match
+   * stay in their order
+   *
+   * @param match match(slot) true if the row is kept
+   */
+  template <typename Match>
+  void keepMatching(Match match) {
+    if (order != nullptr) {
+      uint8_t j = 0;
+      for (size_t i = 0; i < nbOrder; i++) {
+        if (match(order[i])) {
+          order[j] = order[i];
+          j += 1;
+        }
+      }
+      nbOrder = j;
+      return;
+    }
+
+    uint8_t used = (size >= capacity) ? capacity : size;
+    if (!filtered) selectFirst(used);
+
+    for (uint8_t slot = 0; slot < used; slot++) {
+      if (!isSelected(slot)) continue;
+
+      if (!match(slot)) {
+        sel[slot / 8] &= ~(1 << (slot % 8));
+        nbSel -= 1;
+      }
+    }
+    cursorRank = 0;
+    cursorSlot = 0;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Keep only the data on which we work from the rank from to from +
+   * nb - 1 (LIMIT / OFFSET / PAGE). Nothing is read from the memory
+   *
+   * @param from Rank of the first data kept
+   * @param nb Amount of data kept
+   */
+  void keepRanks(uint8_t from, uint8_t nb) {
+    uint8_t amount = amountElt();
+    if (from > amount) from = amount;
+    if (nb > amount - from) nb = amount - from;
+
+    if (order != nullptr) {
+      memmove(order, order + from, nb);
+      nbOrder = nb;
+      return;
+    }
+
+    if (!filtered) {
+      // the data are the slots themselves
+      selectNone();
+      for (int slot = from; slot < from + nb; slot++) sel[slot / 8] |= 1 << (slot % 8);
+      nbSel = nb;
+      return;
+    }
+
+    uint8_t used = (size >= capacity) ? capacity : size;
+    uint8_t rank = 0;
+    for (uint8_t slot = 0; slot < used; slot++) {
+      if (!isSelected(slot)) continue;
+
+      if (rank < from || rank >= from + nb) sel[slot / 8] &= ~(1 << (slot % 8));
+      rank += 1;
+    }
+    nbSel      = nb;
+    cursorRank = 0;
+    cursorSlot = 0;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Read the data on which we work of a numeric or DICT column in the
+   * order of the table, TDB_SCAN_BLOCK bytes at once instead of one byte per
+   * access. A block without selected data is not read, the others are read
+   * from their first to their last selected data. Not for data kept in an
+   * order (ORDER_BY / TOP_K)
+   *
+   * @param pos Position of the column in the table
+   * @param scan scan(slot, cell) with the bytes of the data of each row
+   */
+  template <typename Scan>
+  void scanColumn(int pos, Scan scan) {
+    uint8_t nbBytes  = deduceSizeof(cols[pos].type);
+    int     addrCol  = jumpToColumn(pos, 0);
+    int     step     = stepOf(pos);
+    int     used     = (size >= capacity) ? capacity : size;
+    int     perBlock = (step == nbBytes) ? TDB_SCAN_BLOCK / nbBytes : 1;  // TABLE_ROWS: 1 by 1
+    uint8_t block[TDB_SCAN_BLOCK];
+
+    for (int from = 0; from < used; from += perBlock) {
+      int first = from;
+      int last  = (from + perBlock < used) ? from + perBlock - 1 : used - 1;
+      if (filtered) {
+        while (first <= last && !isSelected(first)) first += 1;
+        while (last > first && !isSelected(last)) last -= 1;
+        if (first > last) continue;
+      }
+
+      STORAGE.readBlock(addrCol + first * step, block, (last - first) * step + nbBytes);
+      for (int slot = first; slot <= last; slot++) {
+        if (!filtered || isSelected(slot)) scan(slot, block + (slot - first) * step);
+      }
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief keepMatching on the bytes of a numeric or DICT column, read by
+   * blocks (scanColumn)
+   *
+   * @param pos Position of the column in the table
+   * @param match match(cell) true if the row is kept
+   */
+  template <typename Match>
+  void keepMatchingCells(int pos, Match match) {
+    uint8_t nbBytes = deduceSizeof(cols[pos].type);
+    int     addrCol = jumpToColumn(pos, 0);
+    int     step    = stepOf(pos);
+
+    if (order != nullptr) {
+      uint8_t cell[4];
+      keepMatching([&](uint8_t slot) {
+        STORAGE.readBlock(addrCol + slot * step, cell, nbBytes);
+        return match((const uint8_t*)cell);
+      });
+      return;
+    }
+
+    if (!filtered) selectFirst((size >= capacity) ? capacity : size);
+
+    scanColumn(pos, [&](uint8_t slot, const uint8_t* cell) {
+      if (!match(cell)) {
+        sel[slot / 8] &= ~(1 << (slot % 8));
+        nbSel -= 1;
+      }
+    });
+    cursorRank = 0;
+    cursorSlot = 0;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Keep the rows of which the data of a numeric column match the
+   * FILTER (WHERE, PreparedQuery). FLOAT16 and FIXED16 data are compared as
+   * float whatever T is, so their fraction isn't lost
+   *
+   * @tparam T
+   * @param pos Position of the column in the table
+   * @param f A filter - enum value
+   * @param operand Value given to the filter
+   */
+  template <typename T>
+  void keepFiltered(int pos, FILTER f, const T& operand) {
+    if (isQuantized(cols[pos].type)) {
+      keepFilteredAs<float>(pos, f, (float)operand);
+    } else {
+      keepFilteredAs<T>(pos, f, operand);
+    }
+  }
+
+  template <typename T>
+  void keepFilteredAs(int pos, FILTER f, const T& operand) {
+    uint8_t                      type  = cols[pos].type;
+    T                            value = operandOf(type, f, operand);
+    typename FilterTest<T>::Test test  = FilterTest<T>::of(f);
+    if (test == nullptr) {
+      selectNone();
+    } else if (f == isEqualTo && !mayContain(pos, value)) {
+      selectNone();  // the Bloom filter of the column doesn't have the value
+    } else {
+      skipZones(pos, f, value);
+      keepMatchingCells(pos, [&](const uint8_t* cell) {
+        return test(cellValue<T>(type, cell), value);
+      });
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Index in the table of the i-th data on which we work: from the
+   * order or the bitmap if they are applied, else the i-th data itself. -1 if
+   * there is no data
+   *
+   * @param i
+   * @return int
+   */
+  int slotAt(uint8_t i) {
+    if (order != nullptr) return i < nbOrder ? order[i] : -1;
+
+    if (!filtered) {
+      uint8_t indexToStop = (size >= capacity) ? capacity : size;
+      return i < indexToStop ? i : -1;
+    }
+
+    if (i >= nbSel) return -1;
+
+    // select: data are mostly read one after the other, so the search goes on
+    // from the last bit found instead of the beginning of the bitmap
+    if (i < cursorRank) {
+      cursorRank = 0;
+      cursorSlot = 0;
+    }
+    uint8_t rank = cursorRank;
+    uint8_t b    = cursorSlot / 8;
+    uint8_t bits = sel[b] & (0xFF << (cursorSlot % 8));
+    for (uint8_t nb = popcount(bits); rank + nb <= i; nb = popcount(bits)) {
+      rank += nb;
+      b += 1;
+      bits = sel[b];
+    }
+    for (; rank < i; rank++) bits &= bits - 1;  // clear the lowest bits set
+
+    uint8_t slot = b * 8;
+    while (!(bits & 1)) {
+      bits >>= 1;
+      slot += 1;
+    }
+
+    cursorRank = i + 1;
+    cursorSlot = slot + 1;
+    return slot;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Another TableData (a handle given by OPEN, the one of MemoryManager)
+   * can insert or delete data in the same table. So the size of the table is
+   * read again at the beginning of each statement: the first operation after
+   * DONE.
+   *
+   * With TDB_CONCURRENT, the first operation which writes takes the lock of
+   * the writers until DONE. If the statement read the table before (WHERE)
+   * and another writer changed it since, nothing is written: DONE returns
+   * false and the statement is run again.
+   *
+   * @param write The operation writes in the table
+   * @return bool False if the operation must not write
+   */
+  bool sync(bool write = false) {
+#if TDB_CONCURRENT
+    if (write && !writing) {
+      bool     nested = WRITER_LOCK.owned();  // its reads are those of the writer
+      uint16_t before = WRITER_LOCK.lock();
+      writing         = true;
+      if (synced && !nested && version != before) torn = true;
+    }
+    if (torn) return false;
+#else
+    (void)write;
+#endif
+    if (synced) return true;
+
+#if TDB_CONCURRENT
+    version = WRITER_LOCK.readBegin();
+#endif
+    refreshSize();
+    synced = true;
+    return true;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief We count the amount of data on which we can work. Read
+   * "initSelection()" comments
+   *
+   * @return uint8_t
+   */
+  uint8_t amountElt() {
+    if (order != nullptr) return nbOrder;
+    if (filtered) return nbSel;
+
+    return (size >= capacity) ? capacity : size;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief We match a give index to the real amount data available to avoid
+   * to be out of bound.
+   *
+   * @param index
+   * @return uint8_t
+   */
+  uint8_t indexMatch(int index) {
+    index = index % amountElt();
+
+    return slotAt(index);
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief In the case of char array, we do some stuff to store these
+   * data and retrieve them, as is it is an array.
+   *
+   * @param from Address wehre we want to store char array
+   * @param nbBytes Amount of bytes used to store the char array
+   * @param value char array to store
+   */
+  void writeCharArray(int from, uint8_t nbBytes, char* value) {
+    uint8_t len = strlen(value) > nbBytes ? nbBytes : strlen(value);
+
+    for (size_t i = 0; i < len; i++) {
+      STORAGE.write(from + i, value[i]);
+    }
+    // a text of nbBytes fills the cell: SELECT reads it without '\0'
+    if (len < nbBytes) STORAGE.write(from + len, '\0');
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief In the case of char array, we do some stuff to store these
+   * data and retrieve them, as is it is an array.
+   *
+   * @param from Address wehre we want to retrieve char array
+   * @param nbBytes Amount of bytes used to retrieve the char array
+   * @param value char array to retrieve
+   */
+  void readCharArray(int from, uint8_t nbBytes, char* value) {
+    for (size_t i = 0; i < nbBytes; i++) {
+      value[i] = (char)STORAGE.read(from + i);
+      if (value[i] == '\0') break;
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Compare a char array of the memory with a text like strncmp: the
+   * bytes are read until the first difference
+   *
+   * @param from Address of the char array
+   * @param nbBytes Amount of bytes used to store the char array
+   * @param value Text compared
+   * @return int <0, 0 or >0 like strcmp(stored, value)
+   */
+  static int compareText(int from, uint8_t nbBytes, const char* value) {
+    for (size_t i = 0; i < nbBytes; i++) {
+      uint8_t c = STORAGE.read(from + i);
+      if (c != (uint8_t)value[i]) return c < (uint8_t)value[i] ? -1 : 1;
+      if (c == '\0') break;
+    }
+    return 0;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Read a numeric data as T. FLOAT16 and FIXED16 data are converted
+   * from their 2 bytes
+   *
+   * @tparam T
+   * @param from Address of the data
+   * @param type Type of the column
+   * @param data Data to hold value
+   */
+  template <typename T>
+  static void getValue(int from, uint8_t type, T& data) {
+    if (isQuantized(type)) {
+      uint16_t raw = 0;
+      STORAGE.get(from, raw);
+      data = (T)dequantize(type, raw);
+    } else {
+      STORAGE.get(from, data);
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Write a numeric data given as T. FLOAT16 and FIXED16 data are
+   * converted to their 2 bytes
+   *
+   * @tparam T
+   * @param from Address of the data
+   * @param type Type of the column
+   * @param data Value to write
+   */
+  template <typename T>
+  static void putValue(int from, uint8_t type, const T& data) {
+    if (isQuantized(type)) {
+      STORAGE.put(from, quantize(type, (float)data));
+    } else {
+      STORAGE.put(from, data);
+    }
+  }
+
+  /**
+   * @brief putValue in the bytes of a data kept in SRAM (stageCell)
+   *
+   * @tparam T
+   * @param type Type of the column
+   * @param data Value to write
+   * @param cell Bytes of the data
+   */
+  template <typename T>
+  static void putCell(uint8_t type, const T& data, uint8_t* cell) {
+    if (isQuantized(type)) {
+      uint16_t raw = quantize(type, (float)data);
+      memcpy(cell, &raw, sizeof(raw));
+    } else {
+      uint8_t nbBytes = deduceSizeof(type);
+      memcpy(cell, &data, sizeof(T) < nbBytes ? sizeof(T) : nbBytes);
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief getValue on the bytes of a data already read (scanColumn): the
+   * bytes are taken as T, FLOAT16 and FIXED16 data are converted
+   *
+   * @tparam T
+   * @param type Type of the column
+   * @param cell Bytes of the data
+   * @return T
+   */
+  template <typename T>
+  static T cellValue(uint8_t type, const uint8_t* cell) {
+    if (isQuantized(type)) {
+      uint16_t raw;
+      memcpy(&raw, cell, sizeof(raw));
+      return (T)dequantize(type, raw);
+    }
+
+    T       data    = 0;
+    uint8_t nbBytes = deduceSizeof(type);
+    memcpy(&data, cell, sizeof(T) < nbBytes ? sizeof(T) : nbBytes);
+    return data;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief The bytes of a data converted to T from the type of its column
+   * (AGGREGATE)
+   *
+   * @tparam T
+   * @param type Type of the column
+   * @param cell Bytes of the data
+   * @return T
+   */
+  template <typename T>
+  static T cellAs(uint8_t type, const uint8_t* cell) {
+    switch (type) {
+      case 3:
+        return (T)cellValue<float>(type, cell);
+      case 4:
+        return (T)cellValue<int>(type, cell);
+      case 5:
+        return (T)cellValue<long>(type, cell);
+      case 7:
+        return (T)cellValue<unsigned int>(type, cell);
+      case 8:
+        return (T)cellValue<unsigned long>(type, cell);
+      default:  // BOOL, BYTE, CHAR, FLOAT16, FIXED16
+        return isQuantized(type) ? cellValue<T>(type, cell) : (T)cell[0];
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Value compared by a FILTER. A FLOAT16 or FIXED16 column holds the
+   * value rounded: isEqualTo and isNotEqualTo compare with the value rounded
+   * the same way, so the value given to INSERT is found again
+   *
+   * @tparam T
+   * @param type Type of the column
+   * @param f A filter - enum value
+   * @param value Value given to the filter
+   * @return T
+   */
+  template <typename T>
+  static T operandOf(uint8_t type, FILTER f, const T& value) {
+    if (!isQuantized(type) || (f != isEqualTo && f != isNotEqualTo)) return value;
+    return (T)dequantize(type, quantize(type, (float)value));
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Write the bytes of a data which are not those it had
+   *
+   * @param from Address of the data
+   * @param before Bytes in memory
+   * @param after Bytes to write
+   * @param len Amount of bytes
+   * @return bool True if a byte is written
+   */
+  static bool writeChanged(int from, const uint8_t* before, const uint8_t* after, uint8_t len) {
+    bool changed = false;
+    for (size_t k = 0; k < len; k++) {
+      if (before[k] != after[k]) {
+        STORAGE.write(from + k, after[k]);
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Read the data of a column of a row, from the row cache if it is
+   * there. A numeric read with the size of its column is kept in the cache
+   *
+   * @param pos Position of the column in the table
+   * @param slot Index of the row in the table
+   * @param data Where to copy the bytes read
+   * @param len Amount of bytes to read
+   */
+  void readCell(int pos, uint8_t slot, uint8_t* data, uint8_t len) {
+    int     from    = jumpToColumn(pos, slot);
+    uint8_t nbBytes = deduceSizeof(cols[pos].type);
+
+    int offset = 0;
+    for (int i = 0; i < pos; i++) {
+      offset += deduceSizeof(cols[i].type);
+    }
+    // the cache only sees the writes in the data of the table on the first device
+    bool cached = TDB_ROW_CACHE > 0 && pos < 16 && len == nbBytes &&
+                  offset + nbBytes <= TDB_ROW_CACHE_BYTES && !(cols[pos].flags & COL_DEVICE2);
+
+    if (cached) {
+      const uint8_t* bytes = ROW_CACHE.find(addr, slot, pos, offset);
+      if (bytes != nullptr) {
+        memcpy(data, bytes, len);
+        return;
+      }
+
+      if (options & TABLE_ROWS) {
+        // the columns kept by the cache are one after the other: one read for all
+        uint8_t row[TDB_ROW_CACHE_BYTES];
+        keepRow(slot, row);
+        memcpy(data, row + offset, len);
+        return;
+      }
+    }
+
+    for (size_t i = 0; i < len; i++) {
+      data[i] = STORAGE.read(from + i);
+    }
+
+    if (cached) {
+      ROW_CACHE.keep(addr, start, start + dataBytes(), slot, pos, offset, data, len);
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Read at once the first columns of a row of a TABLE_ROWS table, as
+   * much as the row cache keeps, and keep them in the cache
+   *
+   * @param slot Index of the row in the table
+   * @param row Where to copy the bytes read, TDB_ROW_CACHE_BYTES
+   */
+  void keepRow(uint8_t slot, uint8_t* row) {
+    uint8_t nbBytes = 0;
+    uint8_t nb      = 0;
+    while (nb < nbCols && nb < 16 && nbBytes + deduceSizeof(cols[nb].type) <= TDB_ROW_CACHE_BYTES) {
+      nbBytes += deduceSizeof(cols[nb].type);
+      nb += 1;
+    }
+    STORAGE.readBlock(jumpToColumn(0, slot), row, nbBytes);
+
+    int end = start + dataBytes();
+    for (uint8_t i = 0, offset = 0; i < nb; offset += deduceSizeof(cols[i].type), i++) {
+      ROW_CACHE.keep(addr, start, end, slot, i, offset, row + offset, deduceSizeof(cols[i].type));
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Allow us to move from an index to another data in the same column
+   * We move uint8_t per uint8_t
+   *
+   * @param addrCol Column address
+   * @param nbBytes Amount of bytes used
+   * @param from Index of the data to move
+   * @param to Index of te destination where to move on
+   */
+  void moveData(int addrCol, int nbBytes, uint8_t from, uint8_t to) {
+    for (int i = 0; i < nbBytes; i++) {
+      int     fromAddr = addrCol + from * nbBytes + i;
+      uint8_t dataRead = STORAGE.read(fromAddr);
+
+      STORAGE.write(addrCol + to * nbBytes + i, dataRead);
+      STORAGE.write(fromAddr, ZERO);
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief We can move a full row of a table from a position to other.
+   * By row we mean: all data of each column of an index
+   * @param from Index of the row to move
+   * @param to Index of where to move the row
+   */
+  void moveRow(uint8_t from, uint8_t to) {
+    if (options & TABLE_ROWS) {
+      moveData(start, rowWidth(), from, to);  // the row is one block
+      return;
+    }
 
-      nbCols = EEPROM.read(_addr - 7);
+    for (size_t i = 0; i < nbCols; i++) {
+      int     pos        = isColumnExist(cols[i].name);
+      int     addrToRead = jumpToColumn(pos, 0);
+      uint8_t nbBytes    = deduceSizeof(cols[i].type);
 
-      _addr -= 8;
+      moveData(addrToRead, nbBytes, from, to);
+    }
+  }
 
-      cols = (AllColumn*)malloc(nbCols * sizeof(AllColumn));
+  /********************************************************************************************************************************/
+  /**
+   * @brief After a delete operation we need to move data from an index to
+   * another to keep the table data contiguous
+   *
+   * @param index
+   */
+  void moveAfterDelete(uint8_t index) {
+    for (size_t i = index + 1; i < capacity; i++) {
+      moveRow(i, i - 1);
+    }
+    if (pkCol >= 0) shiftKeys(index);
 
-      for (size_t i = 0; i < nbCols; i++) {
-        cols[i].name[0] = char(EEPROM.read(_addr - 0));
-        cols[i].name[1] = char(EEPROM.read(_addr - 1));
-        cols[i].name[2] = '\0';  // char(EEPROM.read(szMeta - 2));
+    unselect(index);
+  }
 
-        cols[i].type = EEPROM.read(_addr - 3);
+  /********************************************************************************************************************************/
+  /**
+   * @brief Delete many rows at once: the rows kept move back in one pass, in
+   * their order, each one at most once. The slots freed at the end are set to
+   * ZERO. Only the bytes which change are written
+   *
+   * @param deleted One bit per slot, set for the rows to delete
+   */
+  void compactRows(const uint8_t* deleted) {
+    uint8_t used = (size >= capacity) ? capacity : size;
+
+    // with TABLE_ROWS the rows are moved as a whole, like a column of one data
+    bool   byRow  = options & TABLE_ROWS;
+    size_t nbRuns = byRow ? 1 : nbCols;
+    for (size_t c = 0; c < nbRuns; c++) {
+      int addrCol = jumpToColumn(c, 0);
+      int nbBytes = byRow ? rowWidth() : deduceSizeof(cols[c].type);
+
+      uint8_t to = 0;
+      for (uint8_t from = 0; from < used; from++) {
+        if (deleted[from / 8] & (1 << (from % 8))) continue;
+
+        if (from != to) {
+          for (int k = 0; k < nbBytes; k++) {
+            STORAGE.update(addrCol + to * nbBytes + k, STORAGE.read(addrCol + from * nbBytes + k));
+          }
+        }
+        to += 1;
+      }
 
-        _addr -= 4;
+      for (int k = to * nbBytes; k < used * nbBytes; k++) {
+        STORAGE.update(addrCol + k, ZERO);
       }
     }
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief We use chaining syntax (operations) with TableData to
-   * manipulate its data. And we copy to the TableData instance in MemoryManager
-   * all informations when we locate a table on what to work. So
-   * we need copy assignment operator.
+   * @brief Number of bits set before a slot
    *
-   * @param other
-   * @return TableData&
+   * @param bits One bit per slot
+   * @param slot
+   * @return uint8_t
    */
-  TableData& operator=(const TableData& other) {
-    addr = other.addr;
-    strcpy(name, other.name);
-    capacity = other.capacity;
-    size     = other.size;
-    modSize  = other.modSize;
-    start    = other.start;
-    nbCols   = other.nbCols;
+  static uint8_t countBefore(const uint8_t* bits, uint8_t slot) {
+    uint8_t nb = 0;
+    for (uint8_t i = 0; i < slot / 8; i++) {
+      nb += popcount(bits[i]);
+    }
+    return nb + popcount(bits[slot / 8] & ((1 << (slot % 8)) - 1));
+  }
 
-    currentAction = other.currentAction;
-    indexElt      = (int*)malloc(capacity * sizeof(int));
-    for (size_t i = 0; i < capacity; i++) {
-      indexElt[i] = other.indexElt[i];
+  /********************************************************************************************************************************/
+  /**
+   * @brief Number of bits set in a byte
+   *
+   * @param b
+   * @return uint8_t
+   */
+  static uint8_t popcount(uint8_t b) {
+    static const uint8_t nibble[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+    return nibble[b & 0x0F] + nibble[b >> 4];
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Above we say, we keep only index to work on data, so after
+   * a delete operation for example, the row deleted leaves the data on which we
+   * work and the rows after it move back by one
+   *
+   * @param deleted Slot of the row deleted
+   */
+  void unselect(uint8_t deleted) {
+    if (order != nullptr) {
+      // after ORDER_BY, slots are not sorted: those after the row deleted can
+      // be anywhere in the array
+      uint8_t j = 0;
+      for (size_t i = 0; i < nbOrder; i++) {
+        if (order[i] == deleted) continue;
+        order[j] = order[i] > deleted ? order[i] - 1 : order[i];
+        j += 1;
+      }
+      nbOrder = j;
+    } else if (filtered) {
+      if (isSelected(deleted)) nbSel -= 1;
+      for (uint8_t slot = deleted; slot + 1 < capacity; slot++) {
+        if (isSelected(slot + 1))
+          sel[slot / 8] |= 1 << (slot % 8);
+        else
+          sel[slot / 8] &= ~(1 << (slot % 8));
+      }
+      sel[(capacity - 1) / 8] &= ~(1 << ((capacity - 1) % 8));
+      cursorRank = 0;
+      cursorSlot = 0;
     }
+    // else data stay in their order with the new size
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief We can delete a whole row by put at specific index ZER0 (as uint8_t)
+   * based on the number of bytes need for each column type
+   *
+   * @param index
+   */
+  void eraseRow(uint8_t index) {
+    if (pkCol >= 0) removeKey(index);
 
-    cols = (AllColumn*)malloc(nbCols * sizeof(AllColumn));
     for (size_t i = 0; i < nbCols; i++) {
-      strcpy(cols[i].name, other.cols[i].name);
-      cols[i].type = other.cols[i].type;
-    }
+      int     pos         = isColumnExist(cols[i].name);
+      int     addrToWrite = jumpToColumn(pos, index);
+      uint8_t nbBytes     = deduceSizeof(cols[i].type);
 
-    return *this;
+      for (size_t j = 0; j < nbBytes; j++) {
+        STORAGE.put(addrToWrite + j, ZERO);
+      }
+    }
   }
 
-  ~TableData() {
-    free(cols);
-    free(indexElt);
-
-    cols     = nullptr;
-    indexElt = nullptr;
+  /********************************************************************************************************************************/
+  /**
+   * @brief After a delete operation, we must update the amount of data int he
+   * table
+   *
+   * @param nbDelete Number of data deleted
+   */
+  void sizeAfterDelete(uint8_t nbDelete = 1) {
+    size = size > capacity ? capacity : size;
+    size = (size - nbDelete) < 0 ? 0 : (size - nbDelete);
+    if (options & TABLE_LOG)
+      writeLaps();
+    else
+      STORAGE.write(addr - 5, size);
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief Count amount of data available (like real size) in the table if
-   * WHERE is applied or not
+   * @brief SELECT_ALL once the column is found: data available are read one
+   * after the other from the column, by blocks if they are in the order of
+   * the table
    *
-   * @return uint8_t
+   * @tparam T
+   * @param pos Position of the column in the table
+   * @param data Array to hold data selected
+   * @param nbData amount of data finds
    */
-  uint8_t COUNT() { return amountElt(); }
+  template <typename T>
+  void selectAll(int pos, T* data, int& nbData) {
+    uint8_t amount = amountElt();
+    nbData         = amount;
+    if (amount == 0) return;
+
+    uint8_t type = cols[pos].type;
+    if (isCharArray(type)) {
+      // nothing to read
+    } else if (order != nullptr) {
+      int addrCol = jumpToColumn(pos, 0);
+      int step    = stepOf(pos);
+
+      for (size_t i = 0; i < amount; i++) {
+        getValue(addrCol + slotAt(i) * step, type, data[i]);
+      }
+    } else {
+      size_t i = 0;
+      scanColumn(pos, [&](uint8_t, const uint8_t* cell) {
+        data[i] = cellValue<T>(type, cell);
+        i += 1;
+      });
+    }
+
+    currentAction = ACTION_SELECT;
+  }
 
   /********************************************************************************************************************************/
   /**
-   * @brief Return the capacity or the maximum amount of data that the table can
-   * hold
+   * @brief Copy the slots of the data on which we work in an array, to change
+   * their order (ORDER_BY). Nothing to do if it is already done
    *
-   * @return uint8_t
+   * @return bool False if the heap has no room for them: no data left
    */
-  uint8_t CAPACITY() { return capacity; }
+  bool keepOrder() {
+    if (order != nullptr) return true;
+
+    uint8_t  amount = amountElt();
+    uint8_t* slots  = (uint8_t*)malloc(amount + 1);
+    if (slots == nullptr) {
+      selectNone();
+      return false;
+    }
+
+    for (size_t i = 0; i < amount; i++) {
+      slots[i] = slotAt(i);
+    }
+    order   = slots;
+    nbOrder = amount;
+    return true;
+  }
 
   /********************************************************************************************************************************/
   /**
-   * @brief This function is used to insert a new data at the end of
-   * the table. If the capacity of data of the table is reached, we
-   * re-write from the beginning of the table news data. Also we
-   * use modulo function between table size and its capacity to be
-   * sure that at any time we don't write outside of the table bound.
+   * @brief Compare two values of a column of a given type
    *
-   * @tparam T
-   * @param c_name Column name
-   * @param data Data use want to store - not a char
-   * @return TableData& The current table instance
+   * @param type Type of the column
+   * @param a Bytes of the first value
+   * @param b Bytes of the second value
+   * @param o ASC or DESC
+   * @return bool True if a comes before b in this order
    */
+  static bool isBefore(uint8_t type, const uint8_t* a, const uint8_t* b, ORDER o) {
+    int cmp = 0;
+    switch (type) {
+      case 3:
+        cmp = compareAs<float>(a, b);
+        break;
+      case TYPE_FLOAT16: {
+        uint16_t x, y;
+        memcpy(&x, a, sizeof(x));
+        memcpy(&y, b, sizeof(y));
+        float fx = dequantize(type, x);
+        float fy = dequantize(type, y);
+        cmp      = (fx < fy) ? -1 : (fy < fx);
+        break;
+      }
+      case 4:
+        cmp = compareAs<int>(a, b);
+        break;
+      case 5:
+        cmp = compareAs<long>(a, b);
+        break;
+      case 7:
+        cmp = compareAs<unsigned int>(a, b);
+        break;
+      case 8:
+        cmp = compareAs<unsigned long>(a, b);
+        break;
+      default:  // BOOL, BYTE, CHAR, FIXED16
+        cmp = isQuantized(type) ? compareAs<int16_t>(a, b) : compareAs<uint8_t>(a, b);
+        break;
+    }
+
+    return o == ASC ? cmp < 0 : cmp > 0;
+  }
+
   template <typename T>
-  TableData& INSERT(char* c_name, const T* data) {
-    if (addr < 0) return *this;
+  static int compareAs(const uint8_t* a, const uint8_t* b) {
+    T x, y;
+    memcpy(&x, a, sizeof(T));
+    memcpy(&y, b, sizeof(T));
+    return (x < y) ? -1 : (y < x);
+  }
 
-    int pos = isColumnExist(c_name);
-    if (pos != STATUS_COL_NOT_FOUND) {
-      // PRINT(c_name, pos);
-      uint8_t type = cols[pos].type;
+  /********************************************************************************************************************************/
+  /**
+   * @brief Move down an element of a heap where each element comes after its
+   * children: the top is the last one in the order
+   *
+   * @param root Position of the element
+   * @param n Amount of elements in the heap
+   * @param before before(i, j) true if element i comes before element j
+   * @param swap swap(i, j) exchange elements i and j
+   */
+  template <typename Before, typename Swap>
+  static void siftDown(size_t root, size_t n, Before before, Swap swap) {
+    while (2 * root + 1 < n) {
+      size_t child = 2 * root + 1;
+      if (child + 1 < n && before(child, child + 1)) child += 1;
+      if (!before(root, child)) return;
+
+      swap(root, child);
+      root = child;
+    }
+  }
 
-      int addrToWrite = jumpToColumn(pos, modSize);
+  /**
+   * @brief Sort n elements in place (heap sort)
+   *
+   * @param n Amount of elements
+   * @param before before(i, j) true if element i comes before element j
+   * @param swap swap(i, j) exchange elements i and j
+   */
+  template <typename Before, typename Swap>
+  static void heapSort(size_t n, Before before, Swap swap) {
+    for (size_t r = n / 2; r > 0; r--) siftDown(r - 1, n, before, swap);
+    for (size_t last = n; last > 1; last--) {
+      swap(0, last - 1);
+      siftDown(0, last - 1, before, swap);
+    }
+  }
 
-      if (type <= 9) {
-        EEPROM.put(addrToWrite, *data);
-      }
+  /********************************************************************************************************************************/
+  /**
+   * @brief Read the bytes of a value (key of JOIN, ORDER_BY,...)
+   *
+   * @param from Address of the value
+   * @param nbBytes Amount of bytes of the value
+   * @param key Where to copy the bytes
+   */
+  static void readKey(int from, uint8_t nbBytes, uint8_t* key) {
+    for (size_t i = 0; i < nbBytes; i++) {
+      key[i] = STORAGE.read(from + i);
+    }
+  }
 
-      currentAction = ACTION_INSERT;
+  /**
+   * @brief Hash of a value. A value of one byte is its own hash
+   *
+   * @param key Bytes of the value
+   * @param nbBytes Amount of bytes of the value
+   * @return uint16_t
+   */
+  static uint16_t keyHash(const uint8_t* key, uint8_t nbBytes) {
+    uint16_t h = 0;
+    for (size_t i = 0; i < nbBytes; i++) {
+      h = h * 31 + key[i];
     }
-    return *this;
+    return h;
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief An overload version othe insert template function used for char
-   * array
+   * @brief With TDB_CONCURRENT, false if a writer of another task ran since
+   * the statement read the size of the table (sync): the data read may be
+   * torn. The reads of the task which writes are never torn
    *
-   * @param c_name Column name
-   * @param data Char sequence we want to store
-   * @return TableData& The current table sequence
+   * @return bool True if the data read are valid
    */
-  TableData& INSERT(char* c_name, char* data) {
-    if (addr < 0) return *this;
+  bool readValid() {
+#if TDB_CONCURRENT
+    return writing ? !torn : !synced || WRITER_LOCK.owned() || WRITER_LOCK.readValid(version);
+#else
+    return true;
+#endif
+  }
 
-    int pos = isColumnExist(c_name);
-    if (pos != STATUS_COL_NOT_FOUND) {
-      // PRINT(c_name, pos);
-      uint8_t type = cols[pos].type;
+  /**
+   * @brief Back to the beginning of a statement: no operation and all data
+   * available. The size will be read again by the next operation
+   *
+   */
+  void reset() {
+    currentAction = ACTION_SELECT;
+    rowToInsert   = -1;
+    rejected      = false;
+    free(staged);
+    staged = nullptr;
+    initSelection();
+    synced = false;
+    unlockWriters();
+  }
 
-      int addrToWrite = jumpToColumn(pos, modSize);
+  /**
+   * @brief End of a statement which writes: the lock of the writers is given
+   * back (TDB_CONCURRENT)
+   *
+   */
+  void unlockWriters() {
+#if TDB_CONCURRENT
+    if (writing) WRITER_LOCK.unlock();
+    writing = false;
+    torn    = false;
+#endif
+  }
 
-      if (type > 9) {
-        uint8_t nbBytes = deduceSizeof(type);
-        writeCharArray(addrToWrite, nbBytes, data);
+  /********************************************************************************************************************************/
+  //// INDEX OF THE PRIMARY KEY ////
+  // Open addressing (linear probing) stored after the data of the table: one
+  // byte per entry with the slot of the row, KEY_EMPTY if the entry is free.
+  // The key itself is read from the row.
+
+  int keyIndexAddr() { return start + dataBytes(); }
+
+  uint16_t keyBucket(const uint8_t* key) {
+    return keyHash(key, deduceSizeof(cols[pkCol].type)) % keySlots(capacity);
+  }
+
+  /**
+   * @brief Look for a key in the index
+   *
+   * @param key Bytes of the key
+   * @param bucket Entry where the key is, or the free entry where to add it
+   * @return int Slot of the row or -1 if the key is not found
+   */
+  int findKey(const uint8_t* key, uint16_t& bucket) {
+    uint8_t  nbBytes = deduceSizeof(cols[pkCol].type);
+    uint16_t nb      = keySlots(capacity);
+    int      from    = keyIndexAddr();
+    uint8_t  keyRead[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+
+    bucket = keyBucket(key);
+    for (uint16_t i = 0; i < nb; i++) {
+      uint8_t slot = STORAGE.read(from + bucket);
+      if (slot == KEY_EMPTY) return -1;
+
+      readKey(jumpToColumn(pkCol, slot), nbBytes, keyRead);
+      if (memcmp(key, keyRead, nbBytes) == 0) return slot;
+
+      bucket = (bucket + 1) % nb;
+    }
+
+    return -1;
+  }
+
+  /**
+   * @brief Index the key of a row. If the key is already indexed for another
+   * row, the index points to this one
+   *
+   * @param slot Index of the row in the table
+   */
+  void addKey(uint8_t slot) {
+    uint8_t key[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+    readKey(jumpToColumn(pkCol, slot), deduceSizeof(cols[pkCol].type), key);
+
+    uint16_t bucket;
+    findKey(key, bucket);
+    STORAGE.update(keyIndexAddr() + bucket, slot);
+  }
+
+  /**
+   * @brief Check that a key can be written in a row: a key in another row
+   * rejects the statement
+   *
+   * @param data Bytes of the key given
+   * @param nbData sizeof the key given
+   * @param slot Row where the key is written
+   * @return bool True if another row has the key
+   */
+  bool keyTaken(const uint8_t* data, uint8_t nbData, uint8_t slot) {
+    uint8_t key[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)] = {0};
+    uint8_t nbBytes = deduceSizeof(cols[pkCol].type);
+    memcpy(key, data, nbData < nbBytes ? nbData : nbBytes);
+
+    uint16_t bucket;
+    int      found = findKey(key, bucket);
+    if (found < 0 || found == slot) return false;
+
+    rejected      = true;
+    currentAction = ACTION_SELECT;  // the row isn't added by DONE
+    return true;
+  }
+
+  /**
+   * @brief Remove the key of a row from the index. The entries after it are
+   * moved back so a search never stops on a free entry before its key
+   *
+   * @param slot Index of the row in the table
+   */
+  void removeKey(uint8_t slot) {
+    uint8_t key[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+    readKey(jumpToColumn(pkCol, slot), deduceSizeof(cols[pkCol].type), key);
+
+    uint16_t hole;
+    if (findKey(key, hole) != slot) return;
+
+    uint16_t nb   = keySlots(capacity);
+    int      from = keyIndexAddr();
+    uint16_t j    = hole;
+    for (uint16_t i = 1; i < nb; i++) {
+      j             = (j + 1) % nb;
+      uint8_t other = STORAGE.read(from + j);
+      if (other == KEY_EMPTY) break;
+
+      readKey(jumpToColumn(pkCol, other), deduceSizeof(cols[pkCol].type), key);
+      uint16_t home = keyBucket(key);
+
+      // the entry stays if its home is between the hole and itself
+      bool stays = (hole < j) ? (home > hole && home <= j) : (home > hole || home <= j);
+      if (!stays) {
+        STORAGE.update(from + hole, other);
+        hole = j;
       }
+    }
+    STORAGE.update(from + hole, KEY_EMPTY);
+  }
+
+  /**
+   * @brief After a delete, rows after the one deleted move back by one
+   *
+   * @param deleted Index of the row deleted
+   */
+  void shiftKeys(uint8_t deleted) {
+    uint16_t nb   = keySlots(capacity);
+    int      from = keyIndexAddr();
+    for (uint16_t i = 0; i < nb; i++) {
+      uint8_t slot = STORAGE.read(from + i);
+      if (slot != KEY_EMPTY && slot > deleted) STORAGE.write(from + i, slot - 1);
+    }
+  }
 
-      currentAction = ACTION_INSERT;
+  /**
+   * @brief After compactRows, each key follows its row: it moves back by the
+   * number of rows deleted before it. Their keys are already removed
+   *
+   * @param deleted One bit per slot, set for the rows deleted
+   */
+  void compactKeys(const uint8_t* deleted) {
+    uint16_t nb   = keySlots(capacity);
+    int      from = keyIndexAddr();
+    for (uint16_t i = 0; i < nb; i++) {
+      uint8_t slot = STORAGE.read(from + i);
+      if (slot != KEY_EMPTY) STORAGE.update(from + i, slot - countBefore(deleted, slot));
     }
-    return *this;
   }
-  /********************************************************************************************************************************/
+
   /**
-   * @brief An updata function is just an override methods over a data at
-   * a position in the table. The amount of data doesn't increase or decrease,
-   * just an override. - not char array
+   * @brief Index again the keys of all rows available (after IMPORT)
    *
-   * @tparam T
-   * @param c_name Column name
-   * @param data Data to override
-   * @param nth Position where to override
-   * @return TableData& The current table sequence
    */
-  template <typename T>
-  TableData& UPDATE(char* c_name, const T* data, int nth) {
-    if (addr < 0) return *this;
+  void rebuildKeys() {
+    if (pkCol < 0) return;
+
+    uint16_t nb   = keySlots(capacity);
+    int      from = keyIndexAddr();
+    for (uint16_t i = 0; i < nb; i++) {
+      STORAGE.update(from + i, KEY_EMPTY);
+    }
+
+    uint8_t amount = (size >= capacity) ? capacity : size;
+    for (size_t i = 0; i < amount; i++) {
+      addKey(i);
+    }
+  }
+
+  /********************************************************************************************************************************/
+  //// NEW ROW KEPT UNTIL DONE ////
+  // The INSERT of a new row of a table with a primary key or TABLE_ROLLUP
+  // write in SRAM: one bit per column given, then the bytes of each column (a
+  // text and its '\0' for CHAR and DICT columns). DONE checks the key before a
+  // byte of the row is written, so the order of the INSERT doesn't matter, and
+  // the oldest rows are folded once for each row really written.
+
+  bool stages() { return rowToInsert < 0 && (pkCol >= 0 || (options & TABLE_ROLLUP)); }
+
+  uint8_t stageWidth(int pos) const {
+    uint8_t type = cols[pos].type;
+    if (isDict(type)) return type - TYPE_DICT + 1;
+    return deduceSizeof(type) + (isCharArray(type) ? 1 : 0);
+  }
+
+  int stageOffset(int pos) const {
+    int offset = (nbCols + 7) / 8;
+    for (int i = 0; i < pos; i++) offset += stageWidth(i);
+    return offset;
+  }
 
-    int pos = isColumnExist(c_name);
-    if (pos != STATUS_COL_NOT_FOUND) {
-      // PRINT(c_name, pos);
-      uint8_t type = cols[pos].type;
+  bool isStaged(int pos) { return staged != nullptr && (staged[pos / 8] & (1 << (pos % 8))); }
 
-      int index       = indexMatch(nth);
-      int addrToWrite = jumpToColumn(pos, index);
+  /**
+   * @brief Where the INSERT of a new row keep the data of a column. The
+   * statement is rejected if the heap has no room for the row
+   *
+   * @param pos Position of the column in the table
+   * @return uint8_t* The bytes of the column, cleared - nullptr if rejected
+   */
+  uint8_t* stageCell(int pos) {
+    if (staged == nullptr) staged = (uint8_t*)calloc(stageOffset(nbCols), 1);
+    if (staged == nullptr) {
+      rejected      = true;
+      currentAction = ACTION_SELECT;
+      return nullptr;
+    }
+
+    staged[pos / 8] |= 1 << (pos % 8);
+    uint8_t* cell = staged + stageOffset(pos);
+    memset(cell, 0, stageWidth(pos));
+    return cell;
+  }
 
-      if (type <= 9) {
-        EEPROM.put(addrToWrite, *data);
+  /**
+   * @brief Write the new row kept by INSERT, at DONE. Refused if its primary
+   * key isn't given or is the one of another row
+   *
+   * @return bool True if the row is written
+   */
+  bool writeStaged() {
+    if (pkCol >= 0) {
+      if (!isStaged(pkCol)) {
+        rejected = true;
+        return false;
       }
+      if (keyTaken(staged + stageOffset(pkCol), deduceSizeof(cols[pkCol].type), modSize)) return false;
+    }
 
-      currentAction = ACTION_UPDATE;
+    rollupOldest();  // TABLE_ROLLUP: before the oldest rows are overwritten
+    // the new row replaces the oldest one when the table is full: its key is
+    // no more indexed
+    if (pkCol >= 0 && size >= capacity) removeKey(modSize);
+
+    for (size_t pos = 0; pos < nbCols; pos++) {
+      if (!isStaged(pos)) continue;
+
+      uint8_t  type = cols[pos].type;
+      int      to   = jumpToColumn(pos, modSize);
+      uint8_t* cell = staged + stageOffset(pos);
+      if (isCharArray(type)) {
+        writeCharArray(to, deduceSizeof(type), (char*)cell);
+      } else if (isDict(type)) {
+        STORAGE.write(to, dictCode(pos, (const char*)cell, true));
+      } else {
+        for (size_t k = 0; k < deduceSizeof(type); k++) STORAGE.update(to + k, cell[k]);
+      }
     }
-    return *this;
+    return true;
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief Used for char array
+   * @brief Read again the size of the table: it can be changed by another
+   * TableData working on the same table
    *
-   * @param c_name Column name
-   * @param data Data to override
-   * @param nth Position to update
-   * @return TableData& The current table sequence
    */
-  TableData& UPDATE(char* c_name, char* data, int nth) {
-    if (addr < 0) return *this;
+  void refreshSize() {
+    if (options & TABLE_LOG)
+      recoverSize();
+    else
+      size = STORAGE.read(addr - 5);
+    modSize = size % capacity;
+  }
 
-    int pos = isColumnExist(c_name);
-    if (pos != STATUS_COL_NOT_FOUND) {
-      // PRINT(c_name, pos);
-      uint8_t type = cols[pos].type;
+  /********************************************************************************************************************************/
+  //// LAPS OF AN APPEND LOG ////
+  // One byte per row after the data of the table (and the index of its primary
+  // key): the lap of the ring in which the row was written, 1 to 255 then 1
+  // again, LAP_EMPTY if it never was. The rows before the next one to write
+  // have the last lap, those after it the lap before (or LAP_EMPTY):
+  //
+  //   laps: | 7 | 7 | 7 | 6 | 6 | 6 |    size = capacity + 3
+  //                       ^ next row
 
-      int index       = indexMatch(nth);
-      int addrToWrite = jumpToColumn(pos, index);
+  int lapAddr() { return keyIndexAddr() + (pkCol >= 0 ? keySlots(capacity) : 0); }
 
-      if (type > 9) {
-        uint8_t nbBytes = deduceSizeof(type);
-        writeCharArray(addrToWrite, nbBytes, data);
-      }
+  static uint8_t nextLap(uint8_t lap) { return lap == 255 ? 1 : lap + 1; }
 
-      currentAction = ACTION_UPDATE;
+  /**
+   * @brief Find the size of an append log from the laps of its rows: a binary
+   * search of the first row which hasn't the lap of the first one
+   *
+   */
+  void recoverSize() {
+    int from = lapAddr();
+    lap      = STORAGE.read(from);
+
+    uint8_t lo = 1;
+    uint8_t hi = capacity;
+    while (lo < hi) {
+      uint8_t mid = lo + (hi - lo) / 2;
+      if (STORAGE.read(from + mid) == lap)
+        lo = mid + 1;
+      else
+        hi = mid;
     }
 
-    return *this;
+    // lo: next row to write (capacity if all rows have the same lap)
+    if (lap == LAP_EMPTY)
+      size = 0;
+    else if (lo == capacity || STORAGE.read(from + capacity - 1) != LAP_EMPTY)
+      size = capacity + lo % capacity;
+    else
+      size = lo;
   }
 
-  /********************************************************************************************************************************/
   /**
-   * @brief Retrieve a data from the table memory. Based on the data
-   * type we can retrieve the exact data at position. It returns one
-   * data per time - not char array
+   * @brief Write the laps of the rows from the size: after a DELETE (rows are
+   * moved) or an IMPORT. Only the laps which change are written
    *
-   * @tparam T
-   * @param c_name Column name
-   * @param data Data to hold value
-   * @param nth Position where to get value
-   * @return TableData& The current table sequence
    */
-  template <typename T>
-  TableData& SELECT(char* c_name, T* data, int nth = 0) {
-    if (addr < 0) return *this;
+  void writeLaps() {
+    int     from = lapAddr();
+    uint8_t next = size % capacity;
+    for (size_t i = capacity; i > 0; i--) {
+      lap = LAP_EMPTY;
+      if (size > capacity)
+        lap = (i - 1) < next ? 2 : 1;
+      else if ((i - 1) < size)
+        lap = 1;
+      STORAGE.update(from + i - 1, lap);
+    }
+  }
 
-    int pos = isColumnExist(c_name);
-    if (pos != STATUS_COL_NOT_FOUND) {
-      // PRINT(c_name, pos);
+  /********************************************************************************************************************************/
+  //// DICTIONARIES OF THE DICT COLUMNS ////
+  // After the laps, DICT_ENTRIES entries of nn bytes for each DICTnn column.
+  // The code of a value is its entry. Entries are used in order and never
+  // freed: the first free one (DICT_FREE) ends the dictionary, so the entry
+  // after a new one is marked free.
+
+  int dictAddr(int pos) {
+    int from = lapAddr() + ((options & TABLE_LOG) ? capacity : 0);
+    for (int i = 0; i < pos; i++) {
+      from += dictBytes(cols[i].type);
+    }
+    return from;
+  }
 
-      uint8_t amount = amountElt();
-      if (amount != 0) {
-        int index      = indexMatch(nth);
-        int addrToRead = jumpToColumn(pos, index);
+  // TABLE_STRIPED: start2 is written after the dictionaries
+  int stripeAddr() { return dictAddr(nbCols); }
 
-        uint8_t type = cols[pos].type;
-        if (type <= 9) {
-          EEPROM.get(addrToRead, *data);
-        }
+  /**
+   * @brief Code of a value in the dictionary of a column. The value is cut to
+   * the size of the entries, like a CHARnn
+   *
+   * @param pos Position of the column in the table
+   * @param value Text to find
+   * @param add If true, a value not found is added in the first free entry
+   * @return uint8_t Its code, DICT_NONE if it isn't found (or can't be added)
+   */
+  uint8_t dictCode(int pos, const char* value, bool add) {
+    uint8_t width = cols[pos].type - TYPE_DICT;
+    int     from  = dictAddr(pos);
+
+    for (uint8_t code = 0; code < DICT_ENTRIES; code++) {
+      int entry = from + code * width;
+      if (STORAGE.read(entry) != DICT_FREE) {
+        if (compareText(entry, width, value) == 0) return code;
+        continue;
+      }
 
-        currentAction = ACTION_SELECT;
+      if (!add) break;
+      for (size_t i = 0; i < width; i++) {
+        STORAGE.write(entry + i, value[i]);
+        if (value[i] == '\0') break;
       }
-    } else {
-      data = NULL;
+      if (code + 1 < DICT_ENTRIES) STORAGE.update(entry + width, DICT_FREE);
+      return code;
     }
-    return *this;
+
+    return DICT_NONE;
   }
 
-  /********************************************************************************************************************************/
   /**
-   * @brief For char array
+   * @brief Text of a code of a DICT column: "" for DICT_NONE
    *
-   * @param c_name Column name
-   * @param data char array to get value
-   * @param nth Position where to get value
-   * @return TableData& The current table sequence
+   * @param pos Position of the column in the table
+   * @param code Code read in a row
+   * @param value char array of nn + 1 bytes to hold the text
    */
-  TableData& SELECT(char* c_name, char* data, int nth = 0) {
-    if (addr < 0) return *this;
+  void readDictValue(int pos, uint8_t code, char* value) {
+    uint8_t width = cols[pos].type - TYPE_DICT;
+    value[0]      = '\0';
+    if (code >= DICT_ENTRIES) return;
 
-    int pos = isColumnExist(c_name);
-    if (pos != STATUS_COL_NOT_FOUND) {
-      // PRINT(c_name, pos);
+    readCharArray(dictAddr(pos) + code * width, width, value);
+    value[width] = '\0';
+  }
 
-      uint8_t amount = amountElt();
-      if (amount != 0) {
-        int index      = indexMatch(nth);
-        int addrToRead = jumpToColumn(pos, index);
+  /********************************************************************************************************************************/
+  //// BLOOM FILTERS OF THE BLOOM COLUMNS ////
+  // After the dictionaries (and start2), bloomBytes(capacity) bytes for each
+  // BLOOM column. A value sets BLOOM_HASHES bits of one byte of the filter,
+  // found from the bytes of the value: adding a value writes at most one byte
+  // and a search reads one byte. A bit is never cleared by INSERT or UPDATE:
+  // the filter is built again after a DELETE, a SET and each lap of a full
+  // table, when the values overwritten are forgotten.
+
+  int bloomAddr(int pos) {
+    int from = stripeAddr() + ((options & TABLE_STRIPED) ? 2 : 0);
+    for (int i = 0; i < pos; i++) {
+      if (cols[i].flags & COL_BLOOM) from += bloomBytes(capacity);
+    }
+    return from;
+  }
 
-        uint8_t type = cols[pos].type;
-        if (type > 9) {
-          uint8_t nbBytes = deduceSizeof(type);
-          readCharArray(addrToRead, nbBytes, data);
-        }
+  /**
+   * @brief Byte and bits of a value in the filter of a column. 0.0 and -0.0
+   * of a FLOAT column are equal, so they have the same bits
+   *
+   * @param pos Position of the column in the table
+   * @param value Bytes of the value, as in a row
+   * @param byte Index of the byte of the value in the filter
+   * @return uint8_t Bits of the value in this byte
+   */
+  uint8_t bloomMask(int pos, const uint8_t* value, int& byte) {
+    uint8_t nbBytes = deduceSizeof(cols[pos].type);
+    bool    zero    = false;
+    if (cols[pos].type == 3) {
+      float f;
+      memcpy(&f, value, sizeof(f));
+      zero = f == 0;
+    }
 
-        currentAction = ACTION_SELECT;
-      }
-    } else {
-      data = NULL;
+    // FNV-1a then a finalizer: the bits of one byte values are spread too
+    uint32_t h = 2166136261UL;
+    for (size_t i = 0; i < nbBytes; i++) {
+      h = (h ^ (zero ? 0 : value[i])) * 16777619UL;
     }
-    return *this;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6DUL;
+    h ^= h >> 12;
+
+    byte         = (h >> 16) % bloomBytes(capacity);
+    uint8_t mask = 0;
+    for (size_t k = 0; k < BLOOM_HASHES; k++) {
+      uint8_t bit = (h >> (3 * k)) & 7;
+      while (mask & (1 << bit)) bit = (bit + 1) & 7;  // BLOOM_HASHES different bits
+      mask |= 1 << bit;
+    }
+    return mask;
   }
 
-  /********************************************************************************************************************************/
   /**
-   * @brief Retireve all data possible from the table. If WHERE methods
-   * is used, it returns only data that match the FILTER
+   * @brief Add the value of a row to the filter of its column. The byte is
+   * written only if it gets a new bit
+   *
+   * @param pos Position of the column in the table
+   * @param slot Index of the row in the table
+   */
+  void addBloom(int pos, uint8_t slot) {
+    uint8_t value[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+    readKey(jumpToColumn(pos, slot), deduceSizeof(cols[pos].type), value);
+
+    int     byte;
+    uint8_t mask = bloomMask(pos, value, byte);
+    int     from = bloomAddr(pos) + byte;
+    uint8_t bits = STORAGE.read(from);
+    if ((bits & mask) != mask) STORAGE.write(from, bits | mask);
+  }
+
+  /**
+   * @brief If a value can be in a column: false if it is surely absent. A
+   * column without filter, or a value which isn't compared byte by byte with
+   * the data of the column, can always be there
    *
    * @tparam T
-   * @param c_name Column name
-   * @param data Array to hold data selected
-   * @param nbData amount of data finds. Zero if no data is found or match.
-   * @return TableData& The current table sequence
+   * @param pos Position of the column in the table
+   * @param value Value to find
+   * @return bool
    */
   template <typename T>
-  TableData& SELECT_ALL(char* c_name, T* data, int& nbData) {
-    if (addr < 0) return *this;
-
-    int pos = isColumnExist(c_name);
-    if (pos != STATUS_COL_NOT_FOUND) {
-      uint8_t amount = amountElt();
-      nbData         = amount;
-      if (amount != 0) {
-        uint8_t type = cols[pos].type;
+  bool mayContain(int pos, const T& value) {
+    uint8_t type = cols[pos].type;
+    if (!(cols[pos].flags & COL_BLOOM) || sizeof(T) != deduceSizeof(type)) return true;
+    if ((type == 3) != ((T)0.5 != 0)) return true;  // a float and the bytes of an integer
+
+    int     byte;
+    uint8_t mask = bloomMask(pos, (const uint8_t*)&value, byte);
+    return (STORAGE.read(bloomAddr(pos) + byte) & mask) == mask;
+  }
 
-        if (type <= 9) {
-          for (size_t i = 0; i < amount; i++) {
-            int index      = indexMatch(i);
-            int addrToRead = jumpToColumn(pos, index);
-            EEPROM.get(addrToRead, data[i]);
-          }
+  /**
+   * @brief Build again the filters from the values of all rows available. The
+   * filter is built in SRAM by parts of SEL_SIZE bytes, each one from a pass
+   * on the column, and only its bytes which change are written
+   *
+   */
+  void rebuildBlooms() {
+    uint8_t used    = (size >= capacity) ? capacity : size;
+    int     nbBytes = bloomBytes(capacity);
+    for (size_t pos = 0; pos < nbCols; pos++) {
+      if (!(cols[pos].flags & COL_BLOOM)) continue;
+
+      int     from    = bloomAddr(pos);
+      int     addrCol = jumpToColumn(pos, 0);
+      int     step    = stepOf(pos);
+      uint8_t width   = deduceSizeof(cols[pos].type);
+      for (int part = 0; part < nbBytes; part += SEL_SIZE) {
+        uint8_t bytes[SEL_SIZE] = {0};
+        for (uint8_t slot = 0; slot < used; slot++) {
+          uint8_t value[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+          int     byte;
+          STORAGE.readBlock(addrCol + slot * step, value, width);
+          uint8_t mask = bloomMask(pos, value, byte);
+          if (byte >= part && byte < part + SEL_SIZE) bytes[byte - part] |= mask;
         }
 
-        currentAction = ACTION_SELECT;
+        for (int i = 0; i < SEL_SIZE && part + i < nbBytes; i++) {
+          STORAGE.update(from + part + i, bytes[i]);
+        }
       }
-    } else {
-      data = NULL;
     }
-
-    return *this;
   }
 
   /********************************************************************************************************************************/
+  //// ZONE MAPS OF THE ZONES COLUMNS ////
+  // After the Bloom filters, for each ZONES column the min then the max of
+  // the rows of each zone: rows 0 to ZONE_ROWS - 1, ZONE_ROWS to... The first
+  // row of a zone sets them, the others only widen them: a row overwritten in
+  // a full table stays in its zone until the last row of the zone is written
+  // again, then the zone is built again from its rows. NaN is never a bound.
+
+  int zoneAddr(int pos) {
+    int from = bloomAddr(nbCols);
+    for (int i = 0; i < pos; i++) {
+      if (cols[i].flags & COL_ZONES) from += zoneBytes(capacity, cols[i].type);
+    }
+    return from;
+  }
 
   /**
-   * @brief For char array - Next update of library
+   * @brief If the bytes of a data of a column are a float which is NaN
    *
+   * @param type Type of the column
+   * @param cell Bytes of the data
+   * @return bool
    */
-  //    TableData& SELECT_ALL(char* c_name, ArrayOfChar* data, int& nbData) {
-  //      int pos = isColumnExist(c_name);
-  //      if (pos != STATUS_COL_NOT_FOUND) {
-  //
-  //        uint8_t amount = amountElt();
-  //        nbData = amount;
-  //        if ( amount != 0 ) {
-  //          uint8_t type = cols[pos].type;
-  //
-  //          if (type  > 9 ) {
-  //
-  //            for (size_t i = 0; i < amount; i++) {
-  //              int index = indexMatch(i);
-  //              int addrToRead = jumpToColumn(pos, index);
-  //
-  //              uint8_t nbBytes = deduceSizeof(type);
-  //              readCharArray(addrToRead, nbBytes, data[i].value);
-  //            }
-  //          }
-  //
-  //          currentAction = ACTION_SELECT;
-  //        }
-  //      }
-  //
-  //      return *this;
-  //    }
+  static bool isNaN(uint8_t type, const uint8_t* cell) {
+    if (type != 3 && !isQuantized(type)) return false;
 
-  /********************************************************************************************************************************/
+    float f = cellValue<float>(type, cell);
+    return f != f;
+  }
 
   /**
-   * @brief We can delete a row of the table based on the position. If you apply
-   * a WHERE method before, it will delete only data at the position wanted that
-   * match the FILTER. One row per time is deleted here.
+   * @brief Order of the data of a column, from their bytes
    *
-   * @param nth
-   * @return TableData& The current table sequence
+   * @param type Type of the column
+   * @param a Bytes of a data
+   * @param b Bytes of another data
+   * @return bool a < b
    */
-  TableData& DELETE(int nth = 0) {
-    if (addr < 0) return *this;
-
-    uint8_t amount = amountElt();
-    if (amount != 0) {
-      uint8_t index = indexMatch(nth);
-
-      eraseRow(index);
-
-      moveAfterDelete(index, amount, nth % amount);
-      sizeAfterDelete(1);
-      currentAction = ACTION_DELETE;
-
-      debugDisplayindexElt();
+  static bool isBefore(uint8_t type, const uint8_t* a, const uint8_t* b) {
+    switch (type) {
+      case 3:
+        return cellValue<float>(type, a) < cellValue<float>(type, b);
+      case 4:
+        return cellValue<int>(type, a) < cellValue<int>(type, b);
+      case 5:
+        return cellValue<long>(type, a) < cellValue<long>(type, b);
+      case 7:
+        return cellValue<unsigned int>(type, a) < cellValue<unsigned int>(type, b);
+      case 8:
+        return cellValue<unsigned long>(type, a) < cellValue<unsigned long>(type, b);
+      default:  // BOOL, BYTE, FLOAT16, FIXED16
+        return isQuantized(type) ? cellValue<float>(type, a) < cellValue<float>(type, b)
+                                 : a[0] < b[0];
     }
-
-    return *this;
   }
 
-  /********************************************************************************************************************************/
   /**
-   * @brief Delete all data wanted (if WHERE methods is used before)
+   * @brief Widen the bounds of a zone (min then max) with a data. A bound
+   * which is NaN is replaced
    *
-   * @param nbData Amount of data deleted
-   * @return TableData& The current table sequence
+   * @param type Type of the column
+   * @param bounds Bytes of the min and the max
+   * @param cell Bytes of the data
    */
-  TableData& DELETE_ALL(int& nbData) {
-    if (addr < 0) return *this;
-
-    uint8_t amount = amountElt();
-    nbData         = amount;
-    if (amount != 0) {
-      for (size_t i = 0; i < amount; i++) {
-        uint8_t index = indexMatch(0);
-        eraseRow(index);
-
-        uint8_t currentAmount = amountElt();
-        moveAfterDelete(index, currentAmount, 0);
-        sizeAfterDelete(1);
-      }
-
-      debugDisplayindexElt();
-
-      // size -= amount;
-      currentAction = ACTION_DELETE_ALL;
-    }
+  static void widen(uint8_t type, uint8_t* bounds, const uint8_t* cell) {
+    uint8_t nbBytes = deduceSizeof(type);
+    if (isNaN(type, cell)) return;
 
-    return *this;
+    if (isNaN(type, bounds) || isBefore(type, cell, bounds)) memcpy(bounds, cell, nbBytes);
+    uint8_t* max = bounds + nbBytes;
+    if (isNaN(type, max) || isBefore(type, max, cell)) memcpy(max, cell, nbBytes);
   }
 
-  /********************************************************************************************************************************/
-
   /**
-   * @brief It's used to filter data from the table. So user can decide to get
-   * data that match a condition- numerics data
+   * @brief Add the data of a row to its zone. Only the bytes of the bounds
+   * which change are written
    *
-   * @tparam T
-   * @param c_name Column name
-   * @param f A filter - enum value
-   * @param data Data that column data will be compared
-   * @return TableData&
+   * @param pos Position of the column in the table
+   * @param slot Index of the row in the table
+   * @param newRow true for a row just inserted (DONE)
    */
-  template <typename T>
-  TableData& WHERE(char* c_name, FILTER f, T* data) {
-    if (addr < 0) return *this;
-
-    int pos = isColumnExist(c_name);
-    if (pos != STATUS_COL_NOT_FOUND) {
-      int     addrToRead = jumpToColumn(pos, 0);
-      uint8_t nbBytes    = deduceSizeof(cols[pos].type);
-      uint8_t amount     = amountElt();
-
-      int* copyIndexElt = malloc(capacity * sizeof(int));
-      for (size_t j = 0; j < capacity; j++) {
-        copyIndexElt[j] = -1;
-      }
-      size_t j = 0;
-
-      if (cols[pos].type < 9) {
-        for (size_t i = 0; i < amount; i++) {
-          uint8_t index = indexMatch(i);
-
-          T dataRead = 0;
-          EEPROM.get(addrToRead + index * nbBytes, dataRead);
-          // PRINT("--val--", dataRead);
-
-          switch (f) {
-            case FILTER::isLessThan: {
-              if (dataRead < *data) {
-                copyIndexElt[j] = index;
-                j += 1;
-              }
-              break;
-            }
-
-            case FILTER::isGreaterThan: {
-              if (dataRead > *data) {
-                copyIndexElt[j] = index;
-                j += 1;
-              }
-
-              break;
-            }
-
-            case FILTER::isEqualTo: {
-              if (dataRead == *data) {
-                copyIndexElt[j] = index;
-                j += 1;
-              }
-
-              break;
-            }
-
-            case FILTER::isLessOrEqualTo: {
-              if (dataRead <= *data) {
-                copyIndexElt[j] = index;
-                j += 1;
-              }
-
-              break;
-            }
-
-            case FILTER::isGreaterOrEqualTo: {
-              if (dataRead >= *data) {
-                copyIndexElt[j] = index;
-                j += 1;
-              }
-
-              break;
-            }
-
-            case FILTER::isNotEqualTo: {
-              if (dataRead != *data) {
-                copyIndexElt[j] = index;
-                j += 1;
-              }
-
-              break;
-            }
-
-            default:
-              break;
-          }
-        }
-      }
-      for (size_t k = 0; k < capacity; k++) {
-        indexElt[k] = copyIndexElt[k];
+  void addToZone(int pos, uint8_t slot, bool newRow) {
+    uint8_t type    = cols[pos].type;
+    uint8_t nbBytes = deduceSizeof(type);
+    uint8_t zone    = slot / ZONE_ROWS;
+    int     from    = zoneAddr(pos) + zone * 2 * nbBytes;
+
+    // a row overwritten: the last one of its zone builds the zone again
+    if (newRow && size >= capacity) {
+      if (slot % ZONE_ROWS == ZONE_ROWS - 1 || slot == capacity - 1) {
+        writeZone(pos, zone, capacity);
+        return;
       }
+    }
 
-      free(copyIndexElt);
+    uint8_t cell[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+    uint8_t before[2 * sizeof(cell)];
+    uint8_t after[2 * sizeof(cell)];
+    readKey(jumpToColumn(pos, slot), nbBytes, cell);
+    STORAGE.readBlock(from, before, 2 * nbBytes);
 
-      currentAction = ACTION_WHERE;
+    // the first row of a zone of a table not full: the zone had no row
+    if (newRow && size < capacity && slot % ZONE_ROWS == 0) {
+      memcpy(after, cell, nbBytes);
+      memcpy(after + nbBytes, cell, nbBytes);
+    } else {
+      memcpy(after, before, 2 * nbBytes);
+      widen(type, after, cell);
     }
-
-    return *this;
+    writeChanged(from, before, after, 2 * nbBytes);
   }
 
-  /********************************************************************************************************************************/
-
   /**
-   * @brief Each time that an operation is done on the table, some
-   * informations must be updated to keep consistent the current table data
-   * So user must be call this function all times he ue: INSERT / SELECT /
-   * SELECT_ALL / UPDATE / DELETE / DELETE_ALL
-   */
-  void DONE() {
-    if (currentAction == ACTION_INSERT) {  // INSERTION
-      size += 1;
-
-      if (size == (2 * capacity)) {
-        size = capacity;
-        // PRINT("capacity", capacity);
+   * @brief Build a zone again from its rows
+   *
+   * @param pos Position of the column in the table
+   * @param zone Index of the zone
+   * @param used Rows available in the table
+   */
+  void writeZone(int pos, uint8_t zone, uint8_t used) {
+    uint8_t type    = cols[pos].type;
+    uint8_t nbBytes = deduceSizeof(type);
+    int     from    = zoneAddr(pos) + zone * 2 * nbBytes;
+    int     first   = zone * ZONE_ROWS;
+    int     last    = (first + ZONE_ROWS < used) ? first + ZONE_ROWS : used;
+    if (first >= last) return;
+
+    uint8_t cell[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+    uint8_t before[2 * sizeof(cell)];
+    uint8_t after[2 * sizeof(cell)];
+    int     addrCol = jumpToColumn(pos, 0);
+    int     step    = stepOf(pos);
+    for (int slot = first; slot < last; slot++) {
+      STORAGE.readBlock(addrCol + slot * step, cell, nbBytes);
+      if (slot == first) {
+        memcpy(after, cell, nbBytes);
+        memcpy(after + nbBytes, cell, nbBytes);
+      } else {
+        widen(type, after, cell);
       }
-
-      EEPROM.write(addr - 5, size);  // -5
     }
 
-    currentAction = ACTION_SELECT;
-    initIndexElt();
+    STORAGE.readBlock(from, before, 2 * nbBytes);
+    writeChanged(from, before, after, 2 * nbBytes);
   }
 
-  /********************************************************************************************************************************/
-  //// UTILITIES FUNCTIONS ////
   /**
-   * @brief Verify if a column exist based on the name give as argument
+   * @brief Build again the zone maps from the rows available
    *
-   * @param c_name Column name
-   * @return int A number superior to zero (as column position in the table) if
-   * column is found and inferior if not.
    */
-  int isColumnExist(char* c_name) {
-    for (size_t i = 0; i < nbCols; i++) {
-      if (strcmp(c_name, cols[i].name) == 0) return i;
-    }
+  void rebuildZones() {
+    uint8_t used = (size >= capacity) ? capacity : size;
+    for (size_t pos = 0; pos < nbCols; pos++) {
+      if (!(cols[pos].flags & COL_ZONES)) continue;
 
-    return STATUS_COL_NOT_FOUND;
+      for (int zone = 0; zone * ZONE_ROWS < used; zone++) {
+        writeZone(pos, zone, used);
+      }
+    }
   }
 
- private:
-  /********************************************************************************************************************************/
   /**
-   * @brief Allow us to jump directly at a column position in the table
+   * @brief WHERE on a ZONES column: the rows of the zones which can't have
+   * data which match are not selected, so the scan doesn't read them. Only
+   * when T keeps the order of the data of the column
    *
-   * @param indexCol Position of the column in the data base
-   * @param currentPos Index in this column where we want to operate
-   * @return int The column address in the memory
+   * @tparam T
+   * @param pos Position of the column in the table
+   * @param f A filter - enum value
+   * @param value Value compared, from operandOf
    */
-  int jumpToColumn(size_t indexCol, int currentPos) {
-    int pos = start + deduceSizeof(cols[indexCol].type) * currentPos;
-    for (size_t i = 0; i < indexCol; i++) {
-      pos += deduceSizeof(cols[i].type) * (int)capacity;
+  template <typename T>
+  void skipZones(int pos, FILTER f, const T& value) {
+    uint8_t type    = cols[pos].type;
+    uint8_t nbBytes = deduceSizeof(type);
+    if (!(cols[pos].flags & COL_ZONES) || order != nullptr || f == isNotEqualTo) return;
+
+    bool isFloat  = (T)0.5 != 0;
+    bool isSigned = (T)-1 < 0;
+    if (isQuantized(type) ? !isFloat
+                          : sizeof(T) != nbBytes || isFloat != (type == 3) ||
+                                isSigned != (type == 3 || type == 4 || type == 5)) {
+      return;
     }
 
-    return pos;
+    uint8_t used = (size >= capacity) ? capacity : size;
+    if (!filtered) selectFirst(used);
+
+    int     from = zoneAddr(pos);
+    uint8_t bounds[2 * (sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float))];
+    for (int zone = 0; zone * ZONE_ROWS < used; zone++) {
+      int first = zone * ZONE_ROWS;
+      int last  = (first + ZONE_ROWS < used) ? first + ZONE_ROWS : used;
+
+      bool any = false;  // no need to read the bounds of a zone without row selected
+      for (int slot = first; slot < last && !any; slot++) any = isSelected(slot);
+      if (!any) continue;
+
+      STORAGE.readBlock(from + zone * 2 * nbBytes, bounds, 2 * nbBytes);
+      T    min = cellValue<T>(type, bounds);
+      T    max = cellValue<T>(type, bounds + nbBytes);
+      bool in  = true;
+      switch (f) {
+        case isEqualTo:
+          in = !(value < min) && !(max < value);
+          break;
+        case isLessThan:
+          in = min < value;
+          break;
+        case isLessOrEqualTo:
+          in = !(value < min);
+          break;
+        case isGreaterThan:
+          in = value < max;
+          break;
+        case isGreaterOrEqualTo:
+          in = !(max < value);
+          break;
+        default:
+          break;
+      }
+      if (in) continue;
+
+      for (int slot = first; slot < last; slot++) {
+        if (!isSelected(slot)) continue;
+        sel[slot / 8] &= ~(1 << (slot % 8));
+        nbSel -= 1;
+      }
+    }
+    cursorRank = 0;
+    cursorSlot = 0;
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief To retrieve data or delete them, we keep in an array their
-   * index in table memory. So when WHERE is applied we just update these index
-   * and we can jump to these index in each column for any kind of operation.
-   * If WHERE is not applied, we just keep in their order (0 to capcity -1) data
-   * index
+   * @brief Keep the Bloom filter and the zone map of a column with the data
+   * of a row just written
    *
+   * @param pos Position of the column in the table
+   * @param slot Index of the row in the table
+   * @param newRow true for a row just inserted (DONE)
    */
-  void initIndexElt() {
-    uint8_t indexToStop = (size >= capacity) ? capacity : size;
+  void summarize(int pos, uint8_t slot, bool newRow) {
+    if (cols[pos].flags & COL_BLOOM) addBloom(pos, slot);
+    if (cols[pos].flags & COL_ZONES) addToZone(pos, slot, newRow);
+  }
 
-    for (size_t i = 0; i < capacity; i++) {
-      if (i < indexToStop)
-        indexElt[i] = i;
-      else
-        indexElt[i] = -1;
-    }
+  /**
+   * @brief Build again the Bloom filters and the zone maps (after a DELETE,
+   * a SET or an IMPORT)
+   *
+   */
+  void rebuildSummaries() {
+    rebuildBlooms();
+    rebuildZones();
   }
 
   /********************************************************************************************************************************/
+  //// ROLLUP OF A TABLE_ROLLUP TABLE ////
+  // After the zone maps, ROLLUP_BYTES bytes: the address of the meta data of
+  // the table which gets the rollup rows (int16), the AGGREGATION and the rows
+  // folded in a rollup row, 0 if ROLLUP wasn't called. When the table is full,
+  // the rows nbRows * k to nbRows * (k + 1) - 1 are folded before a new row
+  // is written in the first of them: they are the oldest rows of the ring.
+
+  int rollupAddr() { return zoneAddr(nbCols); }
+
+#if TDB_WITH_ROLLUP
   /**
-   * @brief We count the amount of data on which we can work. Read
-   * "initIndexElt()" comments
+   * @brief Fold the oldest rows into one row of the rollup table if a new row
+   * is about to be written over the first of them. Called by DONE, once the
+   * new row is checked (writeStaged)
    *
-   * @return uint8_t
    */
-  uint8_t amountElt() {
-    uint8_t maxElt = 0;
-    for (size_t i = 0; i < capacity; i++) {
-      if (indexElt[i] >= 0) {
-        maxElt += 1;
+  void rollupOldest() {
+    if (!(options & TABLE_ROLLUP) || size < capacity) return;
+
+    int16_t target = 0;
+    int     from   = rollupAddr();
+    STORAGE.get(from, target);
+    AGGREGATION a      = (AGGREGATION)STORAGE.read(from + 2);
+    uint8_t     nbRows = STORAGE.read(from + 3);
+    if (nbRows == 0 || modSize % nbRows != 0) return;
+
+    TableData into(target);
+    if (into.addr < 0) return;
+
+    // the last rows of the ring are less than nbRows if capacity isn't a multiple
+    uint8_t nb = (capacity - modSize < nbRows) ? capacity - modSize : nbRows;
+    uint8_t cell[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+    for (size_t j = 0; j < into.nbCols; j++) {
+      int pos = isColumnExist(into.cols[j].name);
+      if (pos == STATUS_COL_NOT_FOUND) continue;
+
+      uint8_t type   = cols[pos].type;
+      uint8_t toType = into.cols[j].type;
+      bool    number = toType < 9 || isQuantized(toType);
+      if (number && (type == 3 || isQuantized(type))) {
+        cellOf(toType, fold<float, float>(pos, modSize, nb, a), cell);
+        into.insertCell(j, cell);
+      } else if (number && (type == 4 || type == 5)) {
+        cellOf(toType, fold<long, long>(pos, modSize, nb, a), cell);
+        into.insertCell(j, cell);
+      } else if (number && type < 9) {
+        cellOf(toType, fold<unsigned long, long>(pos, modSize, nb, a), cell);
+        into.insertCell(j, cell);
+      }
+#if TDB_WITH_CHAR
+      else if (!number && (isCharArray(type) || isDict(type))) {
+        // text: the one of the oldest row
+        char text[MAX_CHAR + 1] = "";
+        if (isCharArray(type)) {
+          uint8_t width = deduceSizeof(type) < MAX_CHAR ? deduceSizeof(type) : MAX_CHAR;
+          readCharArray(jumpToColumn(pos, modSize), width, text);
+          text[width] = '\0';
+        } else {
+          uint8_t code = DICT_NONE;
+          readCell(pos, modSize, &code, 1);
+          readDictValue(pos, code, text);
+        }
+        into.INSERT(into.cols[j].name, text);
       }
+#endif
     }
-
-    return maxElt;
+    into.DONE();
   }
 
-  /********************************************************************************************************************************/
   /**
-   * @brief We match a give index to the real amount data available to avoid
-   * to be out of bound.
+   * @brief One value from the data of a numeric column in the rows from to
+   * from + nb - 1, like AGGREGATE. The sum is kept as differences to the first
+   * data, so the average of large values (timestamps) doesn't overflow
    *
-   * @param index
-   * @return uint8_t
+   * @tparam V Type of the value: float, long or unsigned long
+   * @tparam S Type of the sum of the differences: float or long
+   * @param pos Position of the column in the table
+   * @param from First row
+   * @param nb Amount of rows
+   * @param a An aggregation - enum value
+   * @return V
    */
-  uint8_t indexMatch(int index) {
-    index = index % amountElt();
+  template <typename V, typename S>
+  V fold(int pos, uint8_t from, uint8_t nb, AGGREGATION a) {
+    uint8_t type    = cols[pos].type;
+    uint8_t nbBytes = deduceSizeof(type);
+    int     addrCol = jumpToColumn(pos, from);
+    int     step    = stepOf(pos);
+    uint8_t cell[sizeof(unsigned long) > sizeof(float) ? sizeof(unsigned long) : sizeof(float)];
+
+    V first = 0;
+    V value = 0;
+    S sum   = 0;
+    for (uint8_t i = 0; i < nb; i++) {
+      STORAGE.readBlock(addrCol + i * step, cell, nbBytes);
+      V data = cellAs<V>(type, cell);
+      if (i == 0) first = value = data;
+
+      if ((a == minOf && data < value) || (a == maxOf && data > value)) value = data;
+      sum += (S)(data - first);
+    }
 
-    return indexElt[index];
+    if (a == sumOf) return first * nb + (V)sum;
+    if (a == averageOf) return first + (V)(sum / nb);
+    return value;
   }
 
-  /********************************************************************************************************************************/
   /**
-   * @brief In the case of char array, we do some stuff to store these
-   * data and retrieve them, as is it is an array.
+   * @brief The bytes of a data of a column from a value converted to its type:
+   * the reverse of cellAs
    *
-   * @param from Address wehre we want to store char array
-   * @param nbBytes Amount of bytes used to store the char array
-   * @param value char array to store
+   * @tparam V
+   * @param type Type of the column - numerics only
+   * @param value
+   * @param cell Bytes of the data
    */
-  void writeCharArray(int from, uint8_t nbBytes, char* value) {
-    uint8_t len = strlen(value) > nbBytes ? nbBytes : strlen(value);
+  template <typename V>
+  static void cellOf(uint8_t type, V value, uint8_t* cell) {
+    if (isQuantized(type)) {
+      uint16_t raw = quantize(type, (float)value);
+      memcpy(cell, &raw, sizeof(raw));
+      return;
+    }
 
-    for (size_t i = 0; i < len; i++) {
-      EEPROM.write(from + i, value[i]);
+    switch (type) {
+      case 3: {
+        float data = value;
+        memcpy(cell, &data, sizeof(data));
+        break;
+      }
+      case 4: {
+        int data = value;
+        memcpy(cell, &data, sizeof(data));
+        break;
+      }
+      case 5: {
+        long data = value;
+        memcpy(cell, &data, sizeof(data));
+        break;
+      }
+      case 7: {
+        unsigned int data = value;
+        memcpy(cell, &data, sizeof(data));
+        break;
+      }
+      case 8: {
+        unsigned long data = value;
+        memcpy(cell, &data, sizeof(data));
+        break;
+      }
+      default:  // BOOL, BYTE
+        cell[0] = (uint8_t)value;
     }
-    EEPROM.write(from + len, '\0');
   }
 
-  /********************************************************************************************************************************/
   /**
-   * @brief In the case of char array, we do some stuff to store these
-   * data and retrieve them, as is it is an array.
+   * @brief INSERT the bytes of a data of a numeric column, already in the type
+   * of the column (a rollup row)
    *
-   * @param from Address wehre we want to retrieve char array
-   * @param nbBytes Amount of bytes used to retrieve the char array
-   * @param value char array to retrieve
+   * @param pos Position of the column in the table
+   * @param cell Bytes of the data
    */
-  void readCharArray(int from, uint8_t nbBytes, char* value) {
-    for (size_t i = 0; i < nbBytes; i++) {
-      value[i] = (char)EEPROM.read(from + i);
-      if (value[i] == '\0') break;
+  void insertCell(int pos, const uint8_t* cell) {
+    if (!sync(true) || rejected) return;
+
+    uint8_t nbBytes = deduceSizeof(cols[pos].type);
+    if (stages()) {
+      uint8_t* to = stageCell(pos);
+      if (to != nullptr) memcpy(to, cell, nbBytes);
+    } else {
+      int from = jumpToColumn(pos, modSize);
+      for (size_t k = 0; k < nbBytes; k++) {
+        STORAGE.update(from + k, cell[k]);
+      }
     }
+    if (!rejected) currentAction = ACTION_INSERT;
   }
+#else
+  void rollupOldest() {}
+#endif
 
   /********************************************************************************************************************************/
   /**
-   * @brief Allow us to move from an index to another data in the same column
-   * We move uint8_t per uint8_t
+   * @brief Check if the table has the same capacity and columns (name and type)
+   * than the one described
    *
-   * @param addrCol Column address
-   * @param nbBytes Amount of bytes used
-   * @param from Index of the data to move
-   * @param to Index of te destination where to move on
+   * @param cap Capacity
+   * @param nb Number of columns
+   * @param other Columns
+   * @return bool
    */
-  void moveData(int addrCol, uint8_t nbBytes, uint8_t from, uint8_t to) {
-    for (size_t i = 0; i < nbBytes; i++) {
-      int     fromAddr = addrCol + from * nbBytes + i;
-      uint8_t dataRead = EEPROM.read(fromAddr);
+  bool isSameTable(uint8_t cap, uint8_t nb, AllColumn* other, uint8_t opts) {
+    if (cap != capacity || nb != nbCols || opts != options) return false;
 
-      EEPROM.write(addrCol + to * nbBytes + i, dataRead);
-      EEPROM.write(fromAddr, ZERO);
+    for (size_t i = 0; i < nbCols; i++) {
+      if (strcmp(cols[i].name, other[i].name) != 0 || cols[i].type != other[i].type ||
+          cols[i].flags != other[i].flags) {
+        return false;
+      }
     }
+
+    return true;
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief We can move a full row of a table from a position to other.
-   * By row we mean: all data of each column of an index
-   * @param from Index of the row to move
-   * @param to Index of where to move the row
+   * @brief Amount of bytes used by a row: sum of the size of each column
+   *
+   * @return int
    */
-  void moveRow(uint8_t from, uint8_t to) {
+  int rowWidth() {
+    int width = 0;
     for (size_t i = 0; i < nbCols; i++) {
-      int     pos        = isColumnExist(cols[i].name);
-      int     addrToRead = jumpToColumn(pos, 0);
-      uint8_t nbBytes    = deduceSizeof(cols[i].type);
-
-      moveData(addrToRead, nbBytes, from, to);
+      width += deduceSizeof(cols[i].type);
     }
+
+    return width;
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief After a delete operation we need to move data from an index to
-   * another to keep the table data contiguous
+   * @brief Amount of bytes used by the rows on a device: all of them if the
+   * table isn't TABLE_STRIPED
    *
-   * @param index
-   * @param amount
-   * @param currIndex
+   * @param device 0 for the first device, COL_DEVICE2 for the second one
+   * @return int
    */
-  void moveAfterDelete(uint8_t index, uint8_t amount, uint8_t currIndex) {
-    for (size_t i = index + 1; i < capacity; i++) {
-      moveRow(i, i - 1);
+  int dataBytes(uint8_t device = 0) {
+    int width = 0;
+    for (size_t i = 0; i < nbCols; i++) {
+      if ((cols[i].flags & COL_DEVICE2) == device) width += deduceSizeof(cols[i].type);
     }
 
-    reOrderIndexElt(amount, currIndex);
+    return width * (int)capacity;
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief Above we say, we keep only index to work on data, so after
-   * a delete operation fro example, we re-order the array that contains these
-   * index
+   * @brief In images, a row is the data of each column one after the other. We
+   * get where is stored in the memory a byte of this row
    *
-   * @param amount Amount of data (index)
-   * @param currIndex The index of the element where we want to move on
+   * @param slot Index of the row in the table
+   * @param offset Position of the byte in the row
+   * @return int Address of the byte
    */
-  void reOrderIndexElt(uint8_t amount, uint8_t currIndex) {
-    for (size_t i = currIndex + 1; i < amount; i++) {
-      indexElt[i - 1] = indexElt[i] - 1;
+  int rowByteAddr(uint8_t slot, int offset) {
+    for (size_t i = 0; i < nbCols; i++) {
+      uint8_t nbBytes = deduceSizeof(cols[i].type);
+      if (offset < nbBytes) return jumpToColumn(i, slot) + offset;
+      offset -= nbBytes;
     }
-    indexElt[amount - 1] = -1;
+
+    return -1;
   }
 
   /********************************************************************************************************************************/
   /**
-   * @brief We can delete a whole row by put at specific index ZER0 (as uint8_t)
-   * based on the number of bytes need for each column type
+   * @brief Write the table, its columns and the rows available in an image
    *
-   * @param index
+   * @param w Image on which we write
+   * @param keepSlots If true (full image), rows keep their slot and the table
+   * its size so the image is an exact copy. If not, rows are numbered from 0 and
+   * the size is the amount of rows exported
+   * @return int Amount of rows exported
    */
-  void eraseRow(uint8_t index) {
+  int exportTable(ImageWriter& w, bool keepSlots) {
+    uint8_t amount = amountElt();
+
+    w.begin(FRAME_TABLE, 6);
+    w.put(name[0]);
+    w.put(name[1]);
+    w.put(keepSlots ? size : amount);
+    w.put(capacity);
+    w.put(nbCols);
+    w.put(options);
+    w.end();
+
     for (size_t i = 0; i < nbCols; i++) {
-      int     pos         = isColumnExist(cols[i].name);
-      int     addrToWrite = jumpToColumn(pos, index);
-      uint8_t nbBytes     = deduceSizeof(cols[i].type);
+      w.begin(FRAME_COLUMN, 5);
+      w.put(cols[i].name[0]);
+      w.put(cols[i].name[1]);
+      w.put(cols[i].type);
+      w.put(deduceSizeof(cols[i].type));
+      w.put(cols[i].flags);
+      w.end();
+    }
 
-      for (size_t j = 0; j < nbBytes; j++) {
-        EEPROM.put(addrToWrite + j, ZERO);
+    for (size_t i = 0; i < nbCols; i++) {
+      if (!isDict(cols[i].type)) continue;
+
+      uint8_t width = cols[i].type - TYPE_DICT;
+      int     from  = dictAddr(i);
+      for (uint8_t code = 0; code < DICT_ENTRIES; code++) {
+        int entry = from + code * width;
+        if (STORAGE.read(entry) == DICT_FREE) break;
+
+        w.begin(FRAME_DICT, 2 + width);
+        w.put(i);
+        w.put(code);
+        for (size_t k = 0; k < width; k++) {
+          w.put(STORAGE.read(entry + k));
+        }
+        w.end();
       }
     }
-  }
 
-  /********************************************************************************************************************************/
-  /**
-   * @brief After a delete operation, we must update the amount of data int he
-   * table
-   *
-   * @param nbDelete Number of data deleted
-   */
-  void sizeAfterDelete(uint8_t nbDelete = 1) {
-    size = size > capacity ? capacity : size;
-    size = (size - nbDelete) < 0 ? 0 : (size - nbDelete);
-    EEPROM.write(addr - 5, size);
+    int           width   = rowWidth();
+    const uint8_t maxData = FRAME_MAX_PAYLOAD - 3;
+    for (size_t i = 0; i < amount; i++) {
+      uint8_t index = indexMatch(i);
+      uint8_t slot  = keepSlots ? index : i;
+
+      for (int offset = 0; offset < width; offset += maxData) {
+        uint8_t len = (width - offset) > maxData ? maxData : (width - offset);
+
+        w.begin(FRAME_ROW, 3 + len);
+        w.put(slot);
+        w.put(offset & 0xFF);
+        w.put(offset >> 8);
+        for (size_t k = 0; k < len; k++) {
+          w.put(STORAGE.read(rowByteAddr(index, offset + k)));
+        }
+        w.end();
+      }
+    }
+
+    return amount;
   }
 
   /********************************************************************************************************************************/
@@ -977,9 +4972,11 @@ class TableData {
    *
    */
   void debugDisplayindexElt() {
+#if TDB_WITH_PRINT
     for (size_t i = 0; i < capacity; i++) {
-      PRINT("--val--", indexElt[i]);
+      PRINT("--val--", slotAt(i));
     }
+#endif
   }
 
   /********************************************************************************************************************************/
@@ -993,11 +4990,30 @@ class TableData {
                                       // all table row are used - not more than "2*capacity"
   uint8_t    modSize = 0;             // size % capacity to not be bound of table capacity
   int        start   = -1;            // Where in storage memory section, table data are stored
+  int        start2  = -1;            // TABLE_STRIPED: where the columns of the second device are
   uint8_t    nbCols  = 0;             // Number of columns
-  AllColumn* cols    = nullptr;       // Columns informations of the table
-
-  int*    indexElt      = nullptr;        // Array to keep data index and not the data itself
-  uint8_t currentAction = ACTION_SELECT;  // 0: nothing; 1: where search
+  AllColumn  cols[MAX_COLS];          // Columns informations of the table
+
+  uint8_t  sel[SEL_SIZE];                  // Rows on which we work, one bit per slot (WHERE, GET)
+  uint8_t  nbSel         = 0;              // Amount of bits set in sel
+  bool     filtered      = false;          // sel is used - false: all data available
+  uint8_t* order         = nullptr;        // Slots in the order of ORDER_BY / TOP_K - nullptr if none
+  uint8_t  nbOrder       = 0;              // Amount of slots in order
+  uint8_t  cursorRank    = 0;              // slotAt: rank of the next bit set from cursorSlot
+  int      cursorSlot    = 0;              // slotAt: where the search goes on
+  uint8_t  currentAction = ACTION_SELECT;  // 0: nothing; 1: where search
+  bool     synced        = false;          // size read in the current statement
+  int8_t   pkCol         = -1;             // Position of the primary key column - -1 if none
+  uint8_t  options       = 0;              // Options of the table - see TABLE_*
+  uint8_t  lap           = LAP_EMPTY;      // Append log: lap of the last row written
+  int      rowToInsert   = -1;             // Row found by UPSERT where INSERT writes - -1: a new row
+  bool     rejected      = false;          // a key already in the table: the statement writes nothing
+  uint8_t* staged        = nullptr;        // New row (primary key, TABLE_ROLLUP) until DONE - see stageCell
+#if TDB_CONCURRENT
+  uint16_t version = 0;      // WRITER_LOCK version at the beginning of the statement
+  bool     writing = false;  // the statement has the lock of the writers
+  bool     torn    = false;  // another writer ran between the reads and the first write
+#endif
 };
 
 /********************************************************************************************************************************/
@@ -1026,7 +5042,8 @@ class MemoryManager {
 
   /********************************************************************************************************************************/
   /**
-   * @brief We erase all things, let's clean all tables and their meta data
+   * @brief We erase all things, let's clean all tables and their meta data.
+   * The second device (DEVICE) isn't erased: new striped tables write over it
    *
    */
   void clearAll();
@@ -1057,68 +5074,246 @@ class MemoryManager {
 
   /********************************************************************************************************************************/
   /**
-   * @brief Check if they are enough memory available in the data base to store
-   * table data and their meata data.
+   * @brief Check if they are enough memory available in the data base to store
+   * table data and their meata data.
+   *
+   * @param need
+   * @return int
+   */
+  int isMemoryAvailable(int need);
+
+#if TDB_WITH_PRINT
+  /********************************************************************************************************************************/
+  /**
+   * @brief Print meta data informations with their name or key
+   *
+   */
+  void printMetaData();
+#endif
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Create a Table object. With this we can create a new table to work on after
+
+  * @param tableName The table name, no more than 2 char
+  * @param capacity The maximum data that can be hold by this table. If this value is attended, we
+  override old value from the beginning
+  * @param col The number of columns of this table
+  * @param tableCol The informations about columns: name and size
+  * @param options Options of the table: TABLE_LOG for an append log. Its size isn't written at
+  each INSERT (the same byte of the memory would be written for each row) but found from a lap
+  number kept with each row, one more byte per row. TABLE_ROWS to keep the data of a row one
+  after the other (a row is written and read in one place) instead of the data of a column.
+  TABLE_STRIPED to keep the columns 1, 3, 5,... on the second device (see DEVICE): the writes of
+  a row go to both devices and, with ASYNC, the program cycles of the two devices overlap.
+  TABLE_ROLLUP to keep the history of the oldest rows in another table (see ROLLUP)
+  * @return uint8_t We return a status: if table is created, or already existed, if capacity is
+  exceeded or something else... - see status code
+  */
+  int CREATE_TABLE(char* tableName, uint8_t capacity, uint8_t col, Column tableCol[],
+                   uint8_t options = 0);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Keep the history of a table created with TABLE_ROLLUP in another
+   * table, like a round robin database: when the table is full, its oldest
+   * rows are folded by nbRows into one row of the target before a new row is
+   * written over them. Each column of the target gets the aggregation of the
+   * column of the same name (a text column gets the text of the oldest row),
+   * the other columns are not written. A row whose primary key is already in
+   * the target is not written. The target can have its own rollup:
+   *
+   * mem.CREATE_TABLE("TP", 60, 2, cols, TABLE_ROLLUP);  // each minute
+   * mem.CREATE_TABLE("TH", 48, 2, cols);                // each hour
+   * mem.ROLLUP("TP", "TH", averageOf, 60);
+   *
+   * Rows are folded from the first row of the table, nbRows by nbRows: give a
+   * capacity multiple of nbRows. The rollup is kept in the memory: call it
+   * once, and again after IMPORT created the table
+   *
+   * @param tableName The table name
+   * @param target Table which gets the rollup rows
+   * @param a An aggregation - enum value
+   * @param nbRows Rows folded into one rollup row, 1 to the capacity
+   * @return int STATUS_ROLLUP_SET if succeeded, else STATUS_TABLE_NOT_FOUND or
+   * STATUS_BAD_ROLLUP (a table without TABLE_ROLLUP, rows out of the capacity,
+   * a target which folds again into the table)
+   */
+#if TDB_WITH_ROLLUP
+  int ROLLUP(char* tableName, char* target, AGGREGATION a, uint8_t nbRows);
+#else
+  int ROLLUP(char* tableName, char* target, AGGREGATION a, uint8_t nbRows) = delete;
+#endif
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Allow us to check the existence of a table by retrieving its addr. If negative address
+   * is returned, that mean, not exist.
+   *
+   * @param tableName The name of table (max 2 char)
+   * @return int Return its address. Positif if it existed and so where the table meta data started
+   * and negative if it is not existed
+   */
+  int ON(char* tableName);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief This function is used if we wan to set/alter data on the table, insert or update or
+   * delete
+   *
+   * @param tableName The table name
+   * @return TableData& A reference to a member data of MemoryAManager to allow chaining when
+   * working on the table
+   */
+  TableData& TO(char* tableName);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Same thing as TO function but here we use it to get/retrieve informations from the table
+   *
+   * @param tableName Table name
+   * @return TableData& TableData& A reference to a member data of MemoryAManager to allow chaining
+   * when working on the table
+   */
+  TableData& FROM(char* tableName);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Give a TableData of its own on a table. Unlike TO / FROM which share
+   * the TableData of MemoryManager, many tables can be kept open at the same
+   * time, for the lifetime of the sketch:
+   *
+   * TableData logs = mem.OPEN("LG");
+   * TableData conf = mem.OPEN("CF");
+   *
+   * Opening a table reads its meta data once, then each statement only reads
+   * its size again. A TableData opened is no more valid after clearAll.
+   *
+   * @param tableName The table name
+   * @return TableData The table - not found if its COUNT / CAPACITY are zero
+   */
+  TableData OPEN(char* tableName);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Write a binary image of the whole data base (all tables with their
+   * columns and data) on a stream. Data are read and written directly from the
+   * memory without buffer. Each frame of the image has a crc - see FRAME_*
+   *
+   * @param out Where to write the image (Serial, a file,...)
+   * @return int Amount of rows exported
+   */
+  int EXPORT(Stream& out);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Load an image written by EXPORT. Tables which don't exist are created,
+   * existing tables must have the same capacity and columns. A frame is checked
+   * (crc) before being written in the memory, so we stop at the first corrupted
+   * frame: frames before it are already written.
+   *
+   * @param in Where to read the image
+   * @return int STATUS_IMPORTED if succeeded, else STATUS_BAD_IMAGE,
+   * STATUS_TABLE_MISMATCH or the status of the table creation
+   */
+  int IMPORT(Stream& in);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Asynchronous mode: the writes of all operations (INSERT, UPDATE,
+   * DONE,...) are kept in a queue (TDB_WRITE_QUEUE bytes) and written later by
+   * poll or the EEPROM ready interrupt, so they don't block the loop. SELECT,
+   * WHERE,... see the data written even if they are still in the queue. If the
+   * queue is full, a write waits for the oldest byte to be written.
+   *
+   * @param enable false to go back to direct writes (the queue is written first)
+   */
+  void ASYNC(bool enable = true);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Write the next byte of the queue of each device which is ready.
+   * Call it in loop() - it never waits
+   *
+   * @return bool True if bytes are still waiting
+   */
+  bool poll();
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Wait until all writes of the queue are in the memory (before a
+   * reset, to power off,...)
+   *
+   */
+  void SYNC();
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Give the second device (an external EEPROM, a FRAM,...) used by the
+   * TABLE_STRIPED tables. Call it in setup() before working on them, with the
+   * same device at each start: its content isn't checked
    *
-   * @param need
-   * @return int
+   * class I2cEeprom : public StorageDevice { ... };
+   * I2cEeprom ext;
+   * mem.DEVICE(ext);
+   * mem.CREATE_TABLE(name, 64, 4, cols, TABLE_STRIPED);
+   *
+   * @param device The driver of the device
    */
-  int isMemoryAvailable(int need);
+  void DEVICE(StorageDevice& device);
 
   /********************************************************************************************************************************/
   /**
-   * @brief Print meta data informations with their name or key
+   * @brief Hits and misses of the row cache (TDB_ROW_CACHE rows) since the
+   * last reset: many misses on the same rows means the cache is too small
    *
+   * @param reset Set the counters to zero after reading them
+   * @return CacheStats
    */
-  void printMetaData();
+  CacheStats CACHE_STATS(bool reset = false);
 
+ private:
   /********************************************************************************************************************************/
   /**
-   * @brief Create a Table object. With this we can create a new table to work on after
-
-  * @param tableName The table name, no more than 2 char
-  * @param capacity The maximum data that can be hold by this table. If this value is attended, we
-  override old value from the beginning
-  * @param col The number of columns of this table
-  * @param tableCol The informations about columns: name and size
-  * @return uint8_t We return a status: if table is created, or already existed, if capacity is
-  exceeded or something else... - see status code
-  */
-  int CREATE_TABLE(char* tableName, uint8_t capacity, uint8_t col, Column tableCol[]);
+   * @brief Create a table from columns with their type already converted (see
+   * typeIDNum). Used by CREATE_TABLE and IMPORT
+   *
+   * @return int Status code - see CREATE_TABLE
+   */
+  int createTable(char* tableName, uint8_t capacity, uint8_t col, AllColumn tableCol[],
+                  uint8_t options);
 
   /********************************************************************************************************************************/
   /**
-   * @brief Allow us to check the existence of a table by retrieving its addr. If negative address
-   * is returned, that mean, not exist.
+   * @brief First free address of the second device: after the columns of the
+   * TABLE_STRIPED tables
    *
-   * @param tableName The name of table (max 2 char)
-   * @return int Return its address. Positif if it existed and so where the table meta data started
-   * and negative if it is not existed
+   * @return int DEVICE2 + the offset in the device
    */
-  int ON(char* tableName);
+  int device2End();
 
   /********************************************************************************************************************************/
   /**
-   * @brief This function is used if we wan to set/alter data on the table, insert or update or
-   * delete
+   * @brief Read a frame of an image and check its crc
    *
-   * @param tableName The table name
-   * @return TableData& A reference to a member data of MemoryAManager to allow chaining when
-   * working on the table
+   * @param in Where to read
+   * @param type Type of the frame read
+   * @param len Length of the payload
+   * @param payload Buffer of FRAME_MAX_PAYLOAD bytes to hold the payload
+   * @return bool False if the frame can't be read or is corrupted
    */
-  TableData& TO(char* tableName);
+  bool readFrame(Stream& in, uint8_t& type, uint8_t& len, uint8_t* payload);
 
   /********************************************************************************************************************************/
   /**
-   * @brief Same thing as TO function but here we use it to get/retrieve informations from the table
+   * @brief All rows of a table are imported: write its size and index again the
+   * primary key
    *
-   * @param tableName Table name
-   * @return TableData& TableData& A reference to a member data of MemoryAManager to allow chaining
-   * when working on the table
+   * @param table Table imported
+   * @param t_sz Size of the table in the image
    */
-  TableData& FROM(char* tableName);
+  void endImport(TableData& table, uint8_t t_sz);
 
- private:
   /********************************************************************************************************************************/
   /**
    * @brief Set the size (sum of all capacity) of all tables
@@ -1147,63 +5342,126 @@ class MemoryManager {
   void setNbTables(uint8_t nbTab);
 
   /********************************************************************************************************************************/
+  /**
+   * @brief Forget the tables kept in the catalog cache. Tables are never moved
+   * in the memory, so it is needed only when all tables are erased.
+   *
+   */
+  void forgetCatalog();
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Point T_DATA to a table. If it already works on this table, only
+   * its current operation is reset: the meta data are not read again.
+   *
+   * @param tableAddr Address of the table - see ON
+   * @return TableData& T_DATA
+   */
+  TableData& bind(int tableAddr);
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief The TableData of TO / FROM: T_DATA, or the one of the task with
+   * TDB_CONCURRENT
+   *
+   */
+  TableData& current();
+
+#if !TDB_CONCURRENT
   /**
    * @brief It is a TableData used by MemoryManager that user can access to chain functions when
    * working on a table
    *
    */
   TableData T_DATA;
+#endif
+
+  /**
+   * @brief Address of the last tables found by ON - see TDB_CATALOG_CACHE
+   *
+   */
+  struct CatalogEntry {
+    char name[3];
+    int  addr;
+  };
+
+  CatalogEntry catalog[TDB_CATALOG_CACHE];
+  uint8_t      nextEntry = 0;  // entry replaced at the next table found
+#if TDB_CONCURRENT
+  std::mutex catalogLock;  // of catalog only: never held during a read of the memory
+#endif
 };
 
 /********************************************************************************************************************************/
-MemoryManager::MemoryManager() { init(); }
+MemoryManager::MemoryManager() {
+  forgetCatalog();
+  init();
+}
 
 void MemoryManager::init() {
-  int sz = 0;
-  EEPROM.get(ADDR_SIZE_DB, sz);
+  TDB_WRITER;
+  int16_t sz = 0;
+  STORAGE.get(ADDR_SIZE_DB, sz);
 
   if (sz == 0) {
-    EEPROM.put(ADDR_SIZE_METADATA, ADDR_TABLES_METADATA);
+    STORAGE.put(ADDR_SIZE_METADATA, (int16_t)ADDR_TABLES_METADATA);
     setSize(1);
   }
 }
 
 void MemoryManager::clearAll() {
+  TDB_WRITER;
   for (int i = 0; i <= END_DB; i++) {
-    EEPROM.write(i, ZERO);
+    STORAGE.write(i, ZERO);
   }
+  forgetCatalog();
+  current() = TableData();
+#if TDB_WITH_PRINT
   Serial.println("...END...");
+#endif
+}
+
+void MemoryManager::forgetCatalog() {
+#if TDB_CONCURRENT
+  std::lock_guard<std::mutex> guard(catalogLock);
+#endif
+  for (size_t i = 0; i < TDB_CATALOG_CACHE; i++) {
+    catalog[i].addr = STATUS_TABLE_NOT_FOUND;
+  }
 }
 
 int MemoryManager::size() {
-  int sz = 0;
-  EEPROM.get(ADDR_SIZE_DB, sz);
+  int16_t sz = 0;
+  STORAGE.get(ADDR_SIZE_DB, sz);
   return sz;
 }
 
-void MemoryManager::setSize(int nSize) { EEPROM.put(ADDR_SIZE_DB, nSize); }
+void MemoryManager::setSize(int nSize) { STORAGE.put(ADDR_SIZE_DB, (int16_t)nSize); }
 
 int MemoryManager::sizeMeta() {
-  int sz = 0;
-  EEPROM.get(ADDR_SIZE_METADATA, sz);
+  int16_t sz = 0;
+  STORAGE.get(ADDR_SIZE_METADATA, sz);
   return sz;
 }
 
-void MemoryManager::setSizeMeta(int nSizeMeta) { EEPROM.put(ADDR_SIZE_METADATA, nSizeMeta); }
+void MemoryManager::setSizeMeta(int nSizeMeta) {
+  STORAGE.put(ADDR_SIZE_METADATA, (int16_t)nSizeMeta);
+}
 
 uint8_t MemoryManager::nbTables() {
   uint8_t nbCols = 0;
-  nbCols         = EEPROM.read(ADDR_NB_TABLES);
+  nbCols         = STORAGE.read(ADDR_NB_TABLES);
   return nbCols;
 }
 
-void MemoryManager::setNbTables(uint8_t nbTab) { EEPROM.write(ADDR_NB_TABLES, nbTab); }
+void MemoryManager::setNbTables(uint8_t nbTab) { STORAGE.write(ADDR_NB_TABLES, nbTab); }
 
 int MemoryManager::isMemoryAvailable(int need) {
   if (need > (sizeMeta() - size())) return STATUS_INSUF_MEMORY;
   return STATUS_SUF_MEMORY;
 }
 
+#if TDB_WITH_PRINT
 void MemoryManager::printMetaData() {
   // Memory meta data infos
   PRINT("====================", "====================");
@@ -1220,40 +5478,55 @@ void MemoryManager::printMetaData() {
   int szMeta = ADDR_TABLES_METADATA;
   for (size_t i = 0; i < nbTables(); i++) {
     char t_name[3];
-    t_name[0] = char(EEPROM.read(szMeta - 0));
-    t_name[1] = char(EEPROM.read(szMeta - 1));
-    t_name[2] = '\0';  // char(EEPROM.read(szMeta - 2));
+    t_name[0] = char(STORAGE.read(szMeta - 0));
+    t_name[1] = char(STORAGE.read(szMeta - 1));
+    t_name[2] = '\0';  // char(STORAGE.read(szMeta - 2));
     PRINT("Table", t_name);
 
     // PRINT("addr - start", szMeta - 3);
-    int t_start = 0;
-    EEPROM.get(szMeta - 3, t_start);
+    int16_t t_start = 0;
+    STORAGE.get(szMeta - 3, t_start);
     PRINT("start at", t_start);
 
     // PRINT("addr - sz", szMeta - 5);
-    uint8_t t_sz = EEPROM.read(szMeta - 5);
+    uint8_t t_sz    = STORAGE.read(szMeta - 5);
+    uint8_t t_flags = tableFlags(STORAGE.read(szMeta - 4));
+    if (t_flags & TABLE_LOG) {
+      t_sz = TableData(szMeta).size;
+      PRINT("append log", "yes");
+    }
+    if (t_flags & TABLE_ROWS) PRINT("row-major", "yes");
+    if (t_flags & TABLE_STRIPED) PRINT("second device at", TableData(szMeta).start2 - DEVICE2);
+    if (t_flags & TABLE_ROLLUP) PRINT("rollup", "yes");
     PRINT("size", t_sz);
 
     // PRINT("addr - cap", szMeta - 6);
-    uint8_t t_cap = EEPROM.read(szMeta - 6);
+    uint8_t t_cap = STORAGE.read(szMeta - 6);
     PRINT("capacity", t_cap);
 
-    uint8_t t_col = EEPROM.read(szMeta - 7);
+    uint8_t t_col = STORAGE.read(szMeta - 7);
     PRINT("nb col", t_col);
 
     szMeta -= 8;
     for (size_t k = 0; k < t_col; k++) {
       char c_name[3];
-      c_name[0] = char(EEPROM.read(szMeta - 0));
-      c_name[1] = char(EEPROM.read(szMeta - 1));
-      c_name[2] = '\0';  // char(EEPROM.read(szMeta - 2));
+      c_name[0] = char(STORAGE.read(szMeta - 0));
+      c_name[1] = char(STORAGE.read(szMeta - 1));
+      c_name[2] = '\0';  // char(STORAGE.read(szMeta - 2));
 
       PRINT("column", k + 1);
       PRINT("name", c_name);
 
-      uint8_t c_sz = EEPROM.read(szMeta - 3);
+      uint8_t c_sz = STORAGE.read(szMeta - 3);
       PRINT("sizeof", deduceSizeof(c_sz));
 
+      uint8_t c_flags = STORAGE.read(szMeta - 2);
+      if (c_flags & COL_PK) PRINT("primary key", "yes");
+      if (c_flags & COL_BLOOM) PRINT("bloom filter", "yes");
+      if (c_flags & COL_ZONES) PRINT("zone map", "yes");
+      if ((t_flags & TABLE_STRIPED) && (c_flags & COL_DEVICE2)) PRINT("second device", "yes");
+      if (isDict(c_sz)) PRINT("dictionary sizeof", c_sz - TYPE_DICT);
+
       szMeta -= 4;
     }
     PRINT("-", "-");
@@ -1261,16 +5534,81 @@ void MemoryManager::printMetaData() {
 
   PRINT("====================", "====================");
 }
+#endif
+
+int MemoryManager::CREATE_TABLE(char* tableName, uint8_t capacity, uint8_t col, Column tableCol[],
+                                uint8_t options) {
+  AllColumn* allCols = (AllColumn*)malloc(col * sizeof(AllColumn));
+  if (allCols == nullptr) return STATUS_INSUF_MEMORY;  // no SRAM for the columns
+
+  for (size_t i = 0; i < col; i++) {
+    allCols[i].name[0] = tableCol[i].name[0];
+    allCols[i].name[1] = tableCol[i].name[1];
+    allCols[i].name[2] = '\0';
+    allCols[i].type    = typeIDNum(tableCol[i].type);
+    allCols[i].flags   = columnFlags(tableCol[i].type);
+  }
+
+  int status = createTable(tableName, capacity, col, allCols, options);
+  free(allCols);
+
+  return status;
+}
 
-int MemoryManager::CREATE_TABLE(char* tableName, uint8_t capacity, uint8_t col, Column tableCol[]) {
+int MemoryManager::createTable(char* tableName, uint8_t capacity, uint8_t col,
+                               AllColumn tableCol[], uint8_t options) {
+  TDB_WRITER;
   if (capacity > MAX_CAP) return STATUS_MAX_CAP_EXCEEDED;
+  if (col > MAX_COLS) return STATUS_MAX_COLS_EXCEEDED;
+
+  bool striped = options & TABLE_STRIPED;
+  if (striped && ((options & TABLE_ROWS) || STORAGE.device() == nullptr)) return STATUS_BAD_STRIPE;
 
   int dataMemoryNeed = 0;  // to calculate new space needs to stores this table data
+  int device2Need    = 0;  // TABLE_STRIPED: columns 1, 3, 5,... on the second device
+  int nbKeys         = 0;
+  int nbBlooms       = 0;
+  int zonesNeed      = 0;
   for (size_t i = 0; i < col; i++) {
-    dataMemoryNeed += deduceSizeof(typeIDNum(tableCol[i].type));
+    tableCol[i].flags &= ~COL_DEVICE2;
+    if (striped && i % 2 == 1) tableCol[i].flags |= COL_DEVICE2;
+
+    if (tableCol[i].flags & COL_DEVICE2)
+      device2Need += deduceSizeof(tableCol[i].type);
+    else
+      dataMemoryNeed += deduceSizeof(tableCol[i].type);
+    if (tableCol[i].flags & COL_PK) {
+      if (tableCol[i].type >= 9 || isQuantized(tableCol[i].type)) return STATUS_BAD_KEY;
+      nbKeys += 1;
+    }
+    if (tableCol[i].flags & COL_BLOOM) {
+      if (tableCol[i].type >= 9 || isQuantized(tableCol[i].type)) return STATUS_BAD_BLOOM;
+      nbBlooms += 1;
+    }
+    if (tableCol[i].flags & COL_ZONES) {
+      if (tableCol[i].type >= 9 && !isQuantized(tableCol[i].type)) return STATUS_BAD_ZONES;
+      zonesNeed += zoneBytes(capacity, tableCol[i].type);
+    }
   }
+  if (nbKeys > 1) return STATUS_BAD_KEY;
 
   dataMemoryNeed *= capacity;
+  device2Need *= capacity;
+  int rowsMemoryNeed = dataMemoryNeed;  // the index of the primary key is after the rows
+  if (nbKeys == 1) dataMemoryNeed += keySlots(capacity);
+  int lapsMemory = dataMemoryNeed;  // then the laps of an append log
+  if (options & TABLE_LOG) dataMemoryNeed += capacity;
+  int dictsMemory = dataMemoryNeed;  // then the dictionaries of the DICT columns
+  for (size_t i = 0; i < col; i++) {
+    dataMemoryNeed += dictBytes(tableCol[i].type);
+  }
+  int stripeMemory = dataMemoryNeed;  // then where the columns of the second device start
+  if (striped) dataMemoryNeed += 2;
+  int bloomsMemory = dataMemoryNeed;  // then the Bloom filters of the BLOOM columns
+  dataMemoryNeed += nbBlooms * bloomBytes(capacity);
+  dataMemoryNeed += zonesNeed;  // then the zone maps of the ZONES columns
+  int rollupMemory = dataMemoryNeed;  // then the rollup of a TABLE_ROLLUP table
+  if (options & TABLE_ROLLUP) dataMemoryNeed += ROLLUP_BYTES;
 
   int metaMemoryNeed = 4 * col + BYTES_TABLES_GEN_METADATA;
 
@@ -1278,6 +5616,14 @@ int MemoryManager::CREATE_TABLE(char* tableName, uint8_t capacity, uint8_t col,
     return STATUS_INSUF_MEMORY;
   }
 
+  int16_t start2 = 0;
+  if (striped) {
+    start2 = device2End();
+    int end = STORAGE.device()->length();
+    if (end > 0x7FFF - DEVICE2 + 1) end = 0x7FFF - DEVICE2 + 1;
+    if (start2 - DEVICE2 + device2Need > end) return STATUS_INSUF_MEMORY;
+  }
+
   if (ON(tableName) != STATUS_TABLE_NOT_FOUND) {
     return STATUS_TABLE_EXIST;
   }
@@ -1294,45 +5640,81 @@ int MemoryManager::CREATE_TABLE(char* tableName, uint8_t capacity, uint8_t col,
   for (int i = 0; i < 2; i++) {
     int pos = szMeta - i;
     // PRINT("pos", pos);
-    EEPROM.write(pos, tableName[i]);
+    STORAGE.write(pos, tableName[i]);
   }
   szMeta -= 3;
 
   // Store table start storage data
   // PRINT("t_start", szMeta);
-  int start = size();
-  EEPROM.put(szMeta, start);
-  szMeta -= 2;
+  int16_t start = size();
+  STORAGE.put(szMeta, start);
+  szMeta -= 1;
+
+  // Store table options
+  STORAGE.update(szMeta, options);
+  szMeta -= 1;
 
   // Store table size
   // PRINT("t_sz", szMeta);
   uint8_t t_sz = 0;
-  EEPROM.write(szMeta, t_sz);
+  STORAGE.write(szMeta, t_sz);
   szMeta -= 1;
 
   // Store table capacity
   // PRINT("cap", szMeta);
-  EEPROM.write(szMeta, capacity);
+  STORAGE.write(szMeta, capacity);
   szMeta -= 1;
 
   // Store nb cols
   // PRINT("t_nb", szMeta);
-  EEPROM.write(szMeta, col);
+  STORAGE.write(szMeta, col);
   szMeta -= 1;
 
   // cols data
   // PRINT("t_cols", szMeta);
   for (size_t i = 0; i < col; i++) {
-    EEPROM.write(szMeta - 0, tableCol[i].name[0]);
-    EEPROM.write(szMeta - 1, tableCol[i].name[1]);
-    // EEPROM.write(szMeta - 2, '\0');
+    STORAGE.write(szMeta - 0, tableCol[i].name[0]);
+    STORAGE.write(szMeta - 1, tableCol[i].name[1]);
+    STORAGE.update(szMeta - 2, tableCol[i].flags);
 
-    EEPROM.write(szMeta - 3, typeIDNum(tableCol[i].type));
+    STORAGE.write(szMeta - 3, tableCol[i].type);
 
     szMeta -= 4;
   }
   // PRINT("new", szMeta);
 
+  // all entries of the index are free
+  if (nbKeys == 1) {
+    for (int i = 0; i < keySlots(capacity); i++) {
+      STORAGE.update(start + rowsMemoryNeed + i, KEY_EMPTY);
+    }
+  }
+
+  // no row of the log is written
+  if (options & TABLE_LOG) {
+    for (int i = 0; i < capacity; i++) {
+      STORAGE.update(start + lapsMemory + i, LAP_EMPTY);
+    }
+  }
+
+  // dictionaries are empty: their first entry is free
+  for (size_t i = 0; i < col; i++) {
+    if (isDict(tableCol[i].type)) {
+      STORAGE.update(start + dictsMemory, DICT_FREE);
+      dictsMemory += dictBytes(tableCol[i].type);
+    }
+  }
+
+  if (striped) STORAGE.put(start + stripeMemory, start2);
+
+  // no value in the filters
+  for (int i = 0; i < nbBlooms * bloomBytes(capacity); i++) {
+    STORAGE.update(start + bloomsMemory + i, ZERO);
+  }
+
+  // no rollup until ROLLUP is called
+  if (options & TABLE_ROLLUP) STORAGE.update(start + rollupMemory + 3, ZERO);
+
   // Update memory manager meta data infos
   setSize(sz);
   setSizeMeta(szMeta);
@@ -1341,18 +5723,91 @@ int MemoryManager::CREATE_TABLE(char* tableName, uint8_t capacity, uint8_t col,
   return STATUS_TABLE_CREATED;
 }
 
+int MemoryManager::device2End() {
+  int end    = DEVICE2;
+  int szMeta = ADDR_TABLES_METADATA;
+  for (size_t i = 0; i < nbTables(); i++) {
+    TableData table(szMeta);
+    if (table.addr >= 0 && (table.options & TABLE_STRIPED)) {
+      int tableEnd = table.start2 + table.dataBytes(COL_DEVICE2);
+      if (tableEnd > end) end = tableEnd;
+    }
+
+    szMeta -= (BYTES_TABLES_GEN_METADATA + table.nbCols * 4);
+  }
+
+  return end;
+}
+
+void MemoryManager::DEVICE(StorageDevice& device) {
+  TDB_WRITER;
+  STORAGE.setDevice(&device);
+}
+
+#if TDB_WITH_ROLLUP
+int MemoryManager::ROLLUP(char* tableName, char* target, AGGREGATION a, uint8_t nbRows) {
+  TDB_WRITER;
+  int from = ON(tableName);
+  int to   = ON(target);
+  if (from < 0 || to < 0) return STATUS_TABLE_NOT_FOUND;
+
+  TableData table(from);
+  if (table.addr < 0 || !(table.options & TABLE_ROLLUP) || from == to || nbRows == 0 ||
+      nbRows > table.capacity) {
+    return STATUS_BAD_ROLLUP;
+  }
+
+  // the rollup rows of the target must not come back to this table
+  int next = to;
+  for (size_t i = 0; i < nbTables() && next >= 0; i++) {
+    TableData into(next);
+    if (into.addr < 0 || !(into.options & TABLE_ROLLUP)) break;
+
+    int16_t t_next = 0;
+    STORAGE.get(into.rollupAddr(), t_next);
+    if (STORAGE.read(into.rollupAddr() + 3) == 0) break;
+    if (t_next == from) return STATUS_BAD_ROLLUP;
+    next = t_next;
+  }
+
+  int at = table.rollupAddr();
+  STORAGE.put(at, (int16_t)to);
+  STORAGE.update(at + 2, (uint8_t)a);
+  STORAGE.update(at + 3, nbRows);
+
+  return STATUS_ROLLUP_SET;
+}
+#endif
+
 int MemoryManager::ON(char* tableName) {
+  {
+#if TDB_CONCURRENT
+    std::lock_guard<std::mutex> guard(catalogLock);
+#endif
+    for (size_t i = 0; i < TDB_CATALOG_CACHE; i++) {
+      if (catalog[i].addr >= 0 && strcmp(catalog[i].name, tableName) == 0) return catalog[i].addr;
+    }
+  }
+
   int szMeta = ADDR_TABLES_METADATA;
   for (size_t i = 0; i < nbTables(); i++) {
     char t_name[3];
-    t_name[0] = char(EEPROM.read(szMeta - 0));
-    t_name[1] = char(EEPROM.read(szMeta - 1));
+    t_name[0] = char(STORAGE.read(szMeta - 0));
+    t_name[1] = char(STORAGE.read(szMeta - 1));
     t_name[2] = '\0';
 
-    uint8_t t_col = EEPROM.read(szMeta - 7);
+    uint8_t t_col = STORAGE.read(szMeta - 7);
 
     // PRINT("taddr", szMeta);
-    if (strcmp(t_name, tableName) == 0) return szMeta;
+    if (strcmp(t_name, tableName) == 0) {
+#if TDB_CONCURRENT
+      std::lock_guard<std::mutex> guard(catalogLock);
+#endif
+      strcpy(catalog[nextEntry].name, t_name);
+      catalog[nextEntry].addr = szMeta;
+      nextEntry               = (nextEntry + 1) % TDB_CATALOG_CACHE;
+      return szMeta;
+    }
 
     szMeta -= (BYTES_TABLES_GEN_METADATA + t_col * 4);
   }
@@ -1365,15 +5820,408 @@ TableData& MemoryManager::TO(char* tableName) {
   int result = ON(tableName);
   // PRINT("r", result);
 
-  T_DATA = TableData(result);
-  return T_DATA;
+  return bind(result);
 }
 
 TableData& MemoryManager::FROM(char* tableName) {
   int result = ON(tableName);
 
-  T_DATA = TableData(result);
+  return bind(result);
+}
+
+TableData MemoryManager::OPEN(char* tableName) { return TableData(ON(tableName)); }
+
+TableData& MemoryManager::bind(int tableAddr) {
+  TableData& t_data = current();
+  if (tableAddr < 0 || tableAddr != t_data.addr) {
+    t_data = TableData(tableAddr);
+  } else {
+    t_data.reset();
+  }
+
+  return t_data;
+}
+
+TableData& MemoryManager::current() {
+#if TDB_CONCURRENT
+  static thread_local TableData t_data;  // a task doesn't see the statement of another
+  return t_data;
+#else
   return T_DATA;
+#endif
+}
+
+int MemoryManager::EXPORT(Stream& out) {
+  ImageWriter w(out);
+  w.beginImage();
+
+  int     nbRows     = 0;
+  uint8_t nbExported = 0;
+  uint8_t nbT        = nbTables();
+  int     szMeta     = ADDR_TABLES_METADATA;
+  for (size_t i = 0; i < nbT; i++) {
+    TableData table(szMeta);
+    if (table.addr >= 0) {
+      nbRows += table.exportTable(w, true);
+      nbExported += 1;
+    }
+
+    szMeta -= (BYTES_TABLES_GEN_METADATA + table.nbCols * 4);
+  }
+
+  w.endImage(nbExported, nbRows);
+  return nbRows;
+}
+
+int MemoryManager::IMPORT(Stream& in) {
+  TDB_WRITER;
+  uint8_t frame[FRAME_MAX_PAYLOAD];
+  uint8_t type = 0;
+  uint8_t len  = 0;
+
+  if (!readFrame(in, type, len, frame) || type != FRAME_BEGIN || len != 4 || frame[0] != 'T' ||
+      frame[1] != 'D' || frame[2] != 'B' || frame[3] == 0 || frame[3] > FRAME_VERSION) {
+    return STATUS_BAD_IMAGE;
+  }
+
+  TableData  table;  // table on which rows are written - valid after its columns
+  char       t_name[3];
+  uint8_t    t_sz     = 0;
+  uint8_t    t_cap    = 0;
+  uint8_t    t_col    = 0;
+  uint8_t    t_opts   = 0;
+  uint8_t    colsRead = 0;
+  AllColumn* t_cols   = nullptr;
+  int        status   = STATUS_BAD_IMAGE;
+
+  while (readFrame(in, type, len, frame)) {
+    if (type == FRAME_TABLE && (len == 5 || len == 6)) {
+      // the previous table is complete
+      if (table.addr >= 0) endImport(table, t_sz);
+      table = TableData();
+
+      t_name[0] = char(frame[0]);
+      t_name[1] = char(frame[1]);
+      t_name[2] = '\0';
+      t_sz      = frame[2];
+      t_cap     = frame[3];
+      t_col     = frame[4];
+      t_opts    = len == 6 ? frame[5] : 0;
+      colsRead  = 0;
+      if (t_col == 0 || t_cap == 0 || t_sz > 2 * t_cap) break;
+
+      free(t_cols);
+      t_cols = (AllColumn*)malloc(t_col * sizeof(AllColumn));
+      if (t_cols == nullptr) {
+        status = STATUS_INSUF_MEMORY;  // no SRAM for the columns
+        break;
+      }
+    } else if (type == FRAME_COLUMN && (len == 4 || len == 5) && colsRead < t_col) {
+      t_cols[colsRead].name[0] = char(frame[0]);
+      t_cols[colsRead].name[1] = char(frame[1]);
+      t_cols[colsRead].name[2] = '\0';
+      t_cols[colsRead].type    = frame[2];
+      t_cols[colsRead].flags   = len == 5 ? frame[4] : 0;
+      colsRead += 1;
+
+      // sizeof differs: image of a board with other types size
+      if (deduceSizeof(frame[2]) != frame[3]) {
+        status = STATUS_TABLE_MISMATCH;
+        break;
+      }
+
+      if (colsRead == t_col) {
+        int t_addr = ON(t_name);
+        if (t_addr == STATUS_TABLE_NOT_FOUND) {
+          int created = createTable(t_name, t_cap, t_col, t_cols, t_opts);
+          if (created != STATUS_TABLE_CREATED) {
+            status = created;
+            break;
+          }
+          t_addr = ON(t_name);
+        }
+
+        table = TableData(t_addr);
+        if (!table.isSameTable(t_cap, t_col, t_cols, t_opts)) {
+          status = STATUS_TABLE_MISMATCH;
+          break;
+        }
+      }
+    } else if (type == FRAME_DICT && len > 2 && table.addr >= 0) {
+      uint8_t col   = frame[0];
+      uint8_t code  = frame[1];
+      uint8_t width = len - 2;
+      if (col >= t_col || !isDict(t_cols[col].type) || code >= DICT_ENTRIES ||
+          width != t_cols[col].type - TYPE_DICT) {
+        break;
+      }
+
+      // values come in the order of their code: the next one is free
+      int entry = table.dictAddr(col) + code * width;
+      for (size_t k = 2; k < len; k++) {
+        STORAGE.update(entry + k - 2, frame[k]);
+      }
+      if (code + 1 < DICT_ENTRIES) STORAGE.update(entry + width, DICT_FREE);
+    } else if (type == FRAME_ROW && len > 3 && table.addr >= 0) {
+      uint8_t slot   = frame[0];
+      int     offset = frame[1] | (frame[2] << 8);
+      if (slot >= table.capacity || offset + (len - 3) > table.rowWidth()) break;
+
+      for (size_t k = 3; k < len; k++) {
+        STORAGE.update(table.rowByteAddr(slot, offset + k - 3), frame[k]);
+      }
+    } else if (type == FRAME_END && len == 3) {
+      if (table.addr >= 0) endImport(table, t_sz);
+      status = STATUS_IMPORTED;
+      break;
+    } else {
+      break;  // frame not expected here
+    }
+  }
+
+  free(t_cols);
+  return status;
+}
+
+void MemoryManager::endImport(TableData& table, uint8_t t_sz) {
+  if (table.options & TABLE_LOG) {
+    table.size = t_sz;
+    table.writeLaps();
+  } else {
+    STORAGE.write(table.addr - 5, t_sz);
+  }
+  table.refreshSize();
+  table.rebuildKeys();
+  table.rebuildSummaries();
+}
+
+void MemoryManager::ASYNC(bool enable) {
+  TDB_WRITER;
+  STORAGE.setAsync(enable);
+}
+
+bool MemoryManager::poll() {
+#if TDB_CONCURRENT
+  // a byte going from the queue to the memory is a write for the readers. The
+  // writer of another task is not waited: it writes the queue when it is full
+  if (STORAGE.pending() == 0) return false;
+  if (!WRITER_LOCK.tryLock()) return true;
+
+  uint8_t before  = STORAGE.pending();
+  bool    waiting = STORAGE.poll();
+  WRITER_LOCK.unlock(STORAGE.pending() != before);
+  return waiting;
+#else
+  return STORAGE.poll();
+#endif
+}
+
+void MemoryManager::SYNC() {
+  TDB_WRITER;
+  STORAGE.sync();
+}
+
+CacheStats MemoryManager::CACHE_STATS(bool reset) { return ROW_CACHE.stats(reset); }
+
+bool MemoryManager::readFrame(Stream& in, uint8_t& type, uint8_t& len, uint8_t* payload) {
+  uint8_t head[2];
+  if (in.readBytes(head, 2) != 2) return false;
+
+  type = head[0];
+  len  = head[1];
+  if (len > FRAME_MAX_PAYLOAD || in.readBytes(payload, len) != len) return false;
+
+  uint8_t crcRead[2];
+  if (in.readBytes(crcRead, 2) != 2) return false;
+
+  uint16_t crc = crc16(crc16(0xFFFF, type), len);
+  for (size_t i = 0; i < len; i++) {
+    crc = crc16(crc, payload[i]);
+  }
+
+  return crc == (crcRead[0] | (crcRead[1] << 8));
 }
 
+#if TDB_WITH_WHERE
+/********************************************************************************************************************************/
+/**
+ * @brief A query run many times (each sample tick,...). The table, its columns
+ * and the FILTER are resolved once when the query is created, so running it
+ * again only reads the size of the table and scans the column of the filter.
+ * The value compared is read through its pointer at each run: change it
+ * between two runs like a parameter. DONE tells if the data read since
+ * EXECUTE are valid (TDB_CONCURRENT), like TableData::DONE.
+ *
+ * int max_age = 28;
+ * PreparedQuery<int> young(mem, "EM", "ag", FILTER::isLessThan, &max_age);
+ * int ag = young.COLUMN("ag");
+ * ...
+ * young.EXECUTE().SELECT_ALL(ag, age, nbValue).DONE();
+ *
+ * @tparam T Type of the value compared (like WHERE)
+ */
+template <typename T>
+class PreparedQuery {
+ public:
+  /**
+   * @brief Prepare a query: find the table, the column to filter and the
+   * comparison to do
+   *
+   * @param mem The data base
+   * @param tableName Table name
+   * @param c_name Column to filter - numerics only
+   * @param f A filter - enum value
+   * @param value Pointer to the value compared, read at each EXECUTE
+   */
+  PreparedQuery(MemoryManager& mem, char* tableName, char* c_name, FILTER f, const T* value) {
+    table = mem.OPEN(tableName);
+    param = value;
+
+    if (table.addr < 0) return;
+
+    // the query keeps its own bitmap of data which match
+    table.selectNone();
+
+    int pos = table.isColumnExist(c_name);
+    if (pos != STATUS_COL_NOT_FOUND &&
+        (table.cols[pos].type < 9 || isQuantized(table.cols[pos].type))) {
+      column = FilterTest<T>::of(f) != nullptr ? pos : -1;
+      filter = f;
+    }
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Position of a column to use with SELECT / SELECT_ALL, to resolve it
+   * once
+   *
+   * @param c_name Column name
+   * @return int Its position or STATUS_COL_NOT_FOUND
+   */
+  int COLUMN(char* c_name) { return table.isColumnExist(c_name); }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Run the query with the current value of the parameter: keep only
+   * data which match the FILTER
+   *
+   * @return PreparedQuery& The current query
+   */
+  PreparedQuery& EXECUTE() {
+    nbMatch = 0;
+    if (table.addr < 0) return *this;
+
+    // a new statement: the size is read again (and the version of the data
+    // base with TDB_CONCURRENT)
+    table.synced = false;
+    table.sync();
+    uint8_t amount = (table.size >= table.capacity) ? table.capacity : table.size;
+
+    table.selectNone();
+    if (column >= 0) {
+      table.selectFirst(amount);
+      table.keepFiltered(column, filter, *param);
+      nbMatch = table.nbSel;
+    }
+
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Amount of data which match the FILTER at the last EXECUTE
+   *
+   * @return uint8_t
+   */
+  uint8_t COUNT() { return nbMatch; }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief End of a run. With TDB_CONCURRENT, false if a writer of another
+   * task ran since EXECUTE: the data selected may be torn, run it again. The
+   * data which match stay available until the next EXECUTE
+   *
+   * @return bool True if the data read since EXECUTE are valid
+   */
+  bool DONE() { return table.readValid(); }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Get all data which match (last EXECUTE) from a column
+   *
+   * @tparam U
+   * @param col Position of the column - see COLUMN
+   * @param data Array to hold data selected
+   * @param nbData amount of data finds
+   * @return PreparedQuery& The current query
+   */
+  template <typename U>
+  PreparedQuery& SELECT_ALL(int col, U* data, int& nbData) {
+    nbData = 0;
+    if (table.addr < 0 || col < 0 || col >= table.nbCols) return *this;
+
+    table.selectAll(col, data, nbData);
+    return *this;
+  }
+
+  /********************************************************************************************************************************/
+  /**
+   * @brief Get one data which match (last EXECUTE) from a column
+   *
+   * @tparam U
+   * @param col Position of the column - see COLUMN
+   * @param data Data to hold value
+   * @param nth Position of the data among those which match
+   * @return PreparedQuery& The current query
+   */
+  template <typename U>
+  PreparedQuery& SELECT(int col, U* data, int nth = 0) {
+    if (table.addr < 0 || col < 0 || col >= table.nbCols || nbMatch == 0) return *this;
+
+    uint8_t type = table.cols[col].type;
+    if (!isCharArray(type)) {
+      TableData::getValue(table.jumpToColumn(col, table.slotAt(nth % nbMatch)), type, *data);
+    }
+    return *this;
+  }
+
+#if TDB_WITH_CHAR
+  /********************************************************************************************************************************/
+  /**
+   * @brief For char array: the text of a CHARnn column, or the one of the code
+   * of a DICTnn column, like TableData::SELECT
+   *
+   * @param col Position of the column - see COLUMN
+   * @param data char array to get value (nn + 1 bytes for a DICTnn column)
+   * @param nth Position of the data among those which match
+   * @return PreparedQuery& The current query
+   */
+  PreparedQuery& SELECT(int col, char* data, int nth = 0) {
+    if (table.addr < 0 || col < 0 || col >= table.nbCols || nbMatch == 0) return *this;
+
+    uint8_t type = table.cols[col].type;
+    uint8_t slot = table.slotAt(nth % nbMatch);
+    if (isCharArray(type)) {
+      table.readCharArray(table.jumpToColumn(col, slot), deduceSizeof(type), data);
+    } else if (isDict(type)) {
+      uint8_t code = DICT_NONE;
+      table.readCell(col, slot, &code, 1);
+      table.readDictValue(col, code, data);
+    }
+    return *this;
+  }
+#else
+  PreparedQuery& SELECT(int col, char* data, int nth = 0) = delete;
+#endif
+
+ private:
+  TableData table;                // the table with the data which match
+  const T*  param   = nullptr;    // the value compared
+  FILTER    filter  = isEqualTo;  // the FILTER
+  int       column  = -1;         // position of the column filtered, -1 if none
+  uint8_t   nbMatch = 0;          // data which match at the last run
+};
+
+#endif
+
 #endif